@@ -0,0 +1,97 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+** expbench: time the class index LC_CLASS_OF and the rejection test
+** lc_reject of logclass.h, with frexp and ldexp or with the exponent bits
+** of -DLC_FAST_EXPONENT
+**
+**   gcc -O2 -I.. [-DLC_FAST_EXPONENT] expbench.c -o expbench -lm
+**   ./expbench [draws]
+**
+** The reactivities are 2^x with x uniform in -20..20, as in the decades
+** workload of lcbench. For the class: ns per index and whether every
+** index agrees with frexp. For the test: ns per test and the fraction
+** accepted against the exact mean of r/2^ci. run.sh builds and runs both.
+*/
+
+#include <time.h>
+#include "rand55.c"
+#include <logclass.h>
+
+#define EXPBENCH_N 4096
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+  long draws = argc > 1 ? atol(argv[1]) : 100000000;
+  static double r[EXPBENCH_N];
+  static int ci[EXPBENCH_N];
+  const double edge[] = { 0, DBL_MIN / 4, DBL_MIN, 0.5, 1, 1.5, 0x1p-20,
+                          0x1.fffffffffffffp+19, DBL_MAX };
+  rand55_state st;
+  double t_class, t_reject, exact = 0;
+  long i, sum = 0, accepted = 0, wrong = 0;
+  int c, e;
+
+  init_rand55_r(&st, 1234567);
+  for (i = 0; i < EXPBENCH_N; i++)
+    r[i] = exp2(40 * drand55_r(&st) - 20);
+
+  t_class = now();
+  for (i = 0; i < draws; i++) {
+    LC_CLASS_OF(r[i % EXPBENCH_N], c);
+    sum += c;
+  }
+  t_class = now() - t_class;
+  if (sum == 1)   /* keep the loop */
+    puts("");
+
+  for (i = 0; i < EXPBENCH_N; i++) {
+    LC_CLASS_OF(r[i], ci[i]);
+    frexp(r[i], &e);
+    wrong += ci[i] != e;
+    exact += ldexp(r[i], -ci[i]);
+  }
+  for (i = 0; i < (long)(sizeof(edge) / sizeof(*edge)); i++) {
+    LC_CLASS_OF(edge[i], c);
+    frexp(edge[i], &e);
+    /* denormals are below the class range, the fast path gives them 0 */
+    wrong += c != e && !(edge[i] < DBL_MIN && c == 0);
+  }
+
+  t_reject = now();
+  for (i = 0; i < draws; i++)
+    accepted += !lc_reject(&st, ci[i % EXPBENCH_N], r[i % EXPBENCH_N]);
+  t_reject = now() - t_reject;
+
+  printf("%-10s class %6.2f ns  %s  reject %6.2f ns  accepted %.5f (%.5f)\n",
+#ifdef LC_FAST_EXPONENT
+         "fast",
+#else
+         "frexp",
+#endif
+         1e9 * t_class / draws, wrong ? "WRONG" : "same as frexp",
+         1e9 * t_reject / draws, (double)accepted / draws, exact / EXPBENCH_N);
+  return wrong != 0;
+}
@@ -0,0 +1,154 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+** lcbench: time lc_rand and lc_knownchange of one selection backend
+**
+**   gcc -O2 -I.. -DLC_SELECTION=LC_SELECT_TREE lcbench.c -o lcbench -lm
+**   ./lcbench [steps] [events]
+**
+** workloads:
+**   walk     the 1-D random walk of diffusion/model.c, all walkers
+**            start in the middle cell of a lattice of events cells
+**   decay    the same walk from one walker in every cell, walkers decay
+**            at rate 0.05, cells fall to reactivity 0 by reactions, too
+**   uniform  events with reactivities uniform in 0..1
+**   pareto   reactivities u^-2, a heavy tail, a few events dominate
+**   decades  reactivities 2^x with x uniform in -20..20, 40 classes
+** for the last three a drawn event gets a new reactivity of the same
+** distribution. run.sh builds and runs all backends.
+*/
+
+#include <time.h>
+#include <string.h>
+#include "rand55.c"
+#include "logclass.c"
+#include "diffusion/model.c"
+#include "topology.c"
+#include "sagemarkov.c"
+#include "randomwalk.c"
+#include "nsm.c"
+#include "recorder.c"
+#include "moments.c"
+
+#if (LC_SELECTION==LC_SELECT_TREE)
+#define LC_BACKEND "tree"
+#elif (LC_SELECTION==LC_SELECT_LINEAR)
+#define LC_BACKEND "linear"
+#elif defined(LC_CLASS_TREE)
+#define LC_BACKEND "classes+tree"
+#else
+#define LC_BACKEND "classes"
+#endif
+
+typedef double (*bench_dist)(rand55_state *st);
+
+static double bench_uniform(rand55_state *st){ return drand55_r(st); }
+static double bench_pareto(rand55_state *st){ double u = 1.0 - drand55_r(st); return 1/(u*u); }
+static double bench_decades(rand55_state *st){ return ldexp(1.0, (int)lrand55_r(st, 41) - 20) * (1 + drand55_r(st)); }
+
+/* integer reactivities get 10 bits below the unit and stay below 2^40,
+   below 2^32 in the leds of LC_COMPACT_EVENTS */
+#ifdef LC_COMPACT_EVENTS
+#define BENCH_TOP 0x1p21
+#else
+#define BENCH_TOP 0x1p30
+#endif
+static lc_reactivity_t bench_value(double x){
+#ifdef LC_INTEGER_REACTIVITY
+    return (lc_reactivity_t)(1 + ldexp(x < BENCH_TOP ? x : BENCH_TOP, 10));
+#else
+    return (lc_reactivity_t)(x > 0 ? x : lc_reactivity_min);
+#endif
+}
+
+static double bench_seconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+static void bench_report(const char *workload, const lc_global *lc,
+                         size_t events, size_t steps, double seconds){
+    printf("%-13s %-8s %9zu %10zu %8.1f ns/step %6lu reorgs\n", LC_BACKEND,
+           workload, events, steps, 1e9*seconds/steps,
+           (unsigned long) lc->number_of_reorgs);
+}
+
+static void bench_walk(const char *name, double decay, size_t steps, size_t events){
+    sm_topology topology;
+    sm_context  ctx;
+    size_t i;
+    double t;
+
+    memset(&ctx, 0, sizeof(ctx));
+    decay_rate = decay;
+    create_topology(&topology, 1, events);
+    create_walk(&ctx, &topology, events, 4711, 1.0);
+    if ( decay > 0 )
+        for ( i = 0; i < events; i++ ) {
+            ctx.cells[i].n = 1;
+            update_reactivity(&ctx, i);
+        }
+    else {
+        ctx.cells[events/2].n = 100000;
+        update_reactivity(&ctx, events/2);
+    }
+    t = bench_seconds();
+    for ( i = 0; i < steps && ctx.lc.r > LC_EPS(&ctx.lc); i++ )
+        ctx.markov_time += markov_step(&ctx);
+    bench_report(name, &ctx.lc, events, i, bench_seconds() - t);
+    destroy_walk(&ctx);
+    destroy_topology(&topology);
+}
+
+static void bench_dist_run(const char *name, bench_dist dist,
+                           size_t steps, size_t events){
+    lc_global    lc;
+    rand55_state rng;
+    lc_base     *ueds = calloc(events, sizeof(lc_base));
+    size_t i;
+    double t;
+
+    init_rand55_r(&rng, 4711);
+    lc_init(&lc, events, NULL, 1.0);
+    lc.rng = &rng;
+    lc_ued_array(&lc, ueds, sizeof(lc_base));
+    for ( i = 0; i < events; i++ )
+        ueds[i].lc_ev = lc_enter(&lc, ueds+i, bench_value(dist(&rng)));
+    t = bench_seconds();
+    for ( i = 0; i < steps; i++ ) {
+        LC_DRAW_IN(&lc, lc_base, source);
+        source->lc_ev = lc_knownchange(&lc, lc_c, lc_e, source,
+                                       bench_value(dist(&rng)));
+    }
+    bench_report(name, &lc, events, steps, bench_seconds() - t);
+    lc_clear(&lc);
+    free(ueds);
+}
+
+int main(int argc, char **argv){
+    size_t steps  = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+    size_t events = argc > 2 ? strtoul(argv[2], NULL, 10) : 10000;
+
+    bench_walk("walk", 0, steps, events);
+    bench_walk("decay", 0.05, steps, events);
+    bench_dist_run("uniform", bench_uniform, steps, events);
+    bench_dist_run("pareto",  bench_pareto,  steps, events);
+    bench_dist_run("decades", bench_decades, steps, events);
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+** randbench: time the samplers of rand55 and test their distributions
+**
+**   gcc -O2 -I.. [-DRAND55_PHILOX] randbench.c -o randbench -lm
+**   ./randbench [draws]
+**
+** For every sampler: ns per draw, mean, variance, the Kolmogorov-Smirnov
+** distance sqrt(n)*D of a million draws to the exact distribution
+** (above 1.63 with probability 1%) and the fraction of draws beyond x
+** against the exact one. For the Poisson and binomial samplers: ns per
+** draw, mean and variance against the exact ones and chi-square per
+** degree of freedom of a million draws, 1 give or take sqrt(2/df).
+*/
+
+#include <stdlib.h>
+#include <time.h>
+#include "rand55.c"
+
+typedef double (*bench_sampler)(rand55_state *st);
+
+static double cdf_exp(double x)   { return x > 0 ? -expm1(-x) : 0; }
+static double cdf_gauss(double x) { return 0.5 * erfc(-x / sqrt(2)); }
+
+static int cmp_double(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void bench(const char *name, bench_sampler draw, double (*cdf)(double),
+                  double beyond, long draws)
+{
+  static double sample[1000000];
+  const long n = sizeof(sample) / sizeof(*sample);
+  rand55_state st;
+  double t, sum = 0, sq = 0, d = 0, x;
+  long i, out = 0;
+
+  init_rand55_r(&st, 1234567);
+  t = now();
+  for (i = 0; i < draws; i++)
+    sum += draw(&st);
+  t = now() - t;
+  if (sum == 0.5)   /* keep the loop */
+    puts("");
+
+  sum = 0;
+  for (i = 0; i < n; i++) {
+    x = sample[i] = draw(&st);
+    sum += x;
+    sq  += x * x;
+    out += fabs(x) > beyond;
+  }
+  qsort(sample, n, sizeof(*sample), cmp_double);
+  for (i = 0; i < n; i++) {
+    double c = cdf(sample[i]);
+    d = fmax(d, fmax(c - (double)i / n, (double)(i + 1) / n - c));
+  }
+  printf("%-14s %6.2f ns  mean %+.5f  var %.5f  ks %.3f  |x|>%g %.2e (%.2e)\n",
+         name, 1e9 * t / draws, sum / n, sq / n - sum * sum / ((double)n * n),
+         sqrt(n) * d, beyond, (double)out / n,
+         cdf == cdf_exp ? exp(-beyond) : erfc(beyond / sqrt(2)));
+}
+
+/* Poisson for n == 0, else binomial of n trials */
+static double pmf(unsigned long n, double mp, unsigned long k)
+{
+  if (!n)
+    return exp(-mp + k * log(mp) - lgamma(k + 1.0));
+  return exp(lgamma(n + 1.0) - lgamma(k + 1.0) - lgamma(n - k + 1.0)
+             + k * log(mp) + (n - k) * log1p(-mp));
+}
+
+static void bench_discrete(unsigned long n, double mp, long draws)
+{
+  const long samples = 1000000;
+  double mean = n ? n * mp : mp, sd = sqrt(n ? mean * (1 - mp) : mean);
+  long lo = fmax(0, floor(mean - 8 * sd - 10)), bins = 16 * sd + 22, i, *count;
+  rand55_state st;
+  double t, sum = 0, sq = 0, chi = 0, rest = 1;
+  unsigned long k, x = 0;
+  int df = 0;
+
+  init_rand55_r(&st, 1234567);
+  t = now();
+  for (i = 0; i < draws; i++)
+    x += n ? binomial_rand55_r(&st, n, mp) : poisson_rand55_r(&st, mp);
+  t = now() - t;
+  if (x == 1)   /* keep the loop */
+    puts("");
+
+  count = calloc(bins + 1, sizeof(*count));
+  for (i = 0; i < samples; i++) {
+    k = n ? binomial_rand55_r(&st, n, mp) : poisson_rand55_r(&st, mp);
+    sum += k;
+    sq  += (double)k * k;
+    count[(long)k >= lo && (long)k < lo + bins ? (long)k - lo : bins]++;
+  }
+  /* chi-square over the values expected 5 times or more, the rest lumped */
+  for (i = 0; i < bins; i++) {
+    double e = samples * pmf(n, mp, lo + i);
+    if (n && lo + i > (long)n)
+      break;
+    if (e < 5) {
+      count[bins] += count[i];
+      continue;
+    }
+    chi  += (count[i] - e) * (count[i] - e) / e;
+    rest -= e / samples;
+    df++;
+  }
+  if (rest * samples >= 5) {
+    chi += (count[bins] - rest * samples) * (count[bins] - rest * samples) / (rest * samples);
+    df++;
+  }
+  printf("%-9s n %-8lu %-7s %-8g %6.2f ns  mean %.4g (%.4g)  var %.4g (%.4g)  chi2/df %.3f (df %d)\n",
+         n ? "binomial" : "poisson", n, n ? "p" : "mu", mp, 1e9 * t / draws,
+         sum / samples, mean, sq / samples - sum * sum / ((double)samples * samples),
+         sd * sd, chi / (df - 1), df - 1);
+  free(count);
+}
+
+/* raw throughput of rand55_r, the generator chosen at compile time */
+static void bench_raw(long draws)
+{
+  rand55_state st;
+  rand55_t x = 0;
+  double t;
+  long i;
+
+  init_rand55_r(&st, 1234567);
+  t = now();
+  for (i = 0; i < draws; i++)
+    x += rand55_r(&st);
+  t = now() - t;
+  printf("%-14s %6.2f ns  %.2f GB/s%s\n",
+#ifdef RAND55_PHILOX
+         "rand55 philox",
+#else
+         "rand55",
+#endif
+         1e9 * t / draws, draws * sizeof(rand55_t) / t / 1e9, x == 1 ? " " : "");
+}
+
+int main(int argc, char **argv)
+{
+  long draws = argc > 1 ? atol(argv[1]) : 100000000;
+
+  bench_raw(draws);
+  bench("exp log",      exp_log_rand55_r,     cdf_exp,   5, draws);
+  bench("exp zig",      exp_zig_rand55_r,     cdf_exp,   5, draws);
+  bench("gauss alias",  gauss_alias_rand55_r, cdf_gauss, 3, draws);
+  bench("gauss zig",    gauss_zig_rand55_r,   cdf_gauss, 3, draws);
+
+  draws /= 10;
+  bench_discrete(0, 0.1, draws);
+  bench_discrete(0, 3, draws);
+  bench_discrete(0, 9.5, draws);
+  bench_discrete(0, 10, draws);
+  bench_discrete(0, 100, draws);
+  bench_discrete(0, 1e6, draws);
+  bench_discrete(20, 0.3, draws);
+  bench_discrete(1000, 0.009, draws);
+  bench_discrete(1000, 0.2, draws);
+  bench_discrete(100000, 0.7, draws);
+  bench_discrete(1000000000, 0.001, draws);
+  return 0;
+}
@@ -0,0 +1,38 @@
+#!/bin/sh
+# build lcbench for every selection backend and run it on a few sizes,
+# first a short run of each with the checks of -DLC_CHECK_QUEUE, which
+# stops at a broken class list or a led of reactivity 0 left in a class,
+# and of the classes with long double reactivities, whose leds of 32
+# bytes are not aligned to their size by malloc,
+# then expbench with frexp/ldexp and with -DLC_FAST_EXPONENT,
+# usage: run.sh [steps] [sizes ...]
+cd "$(dirname "$0")"
+steps=${1:-1000000}
+shift 2>/dev/null
+sizes=${*:-"100 10000 1000000"}
+CC=${CC:-gcc}
+backends="classes: classes+tree:-DLC_CLASS_TREE tree:-DLC_SELECTION=LC_SELECT_TREE linear:-DLC_SELECTION=LC_SELECT_LINEAR"
+
+for backend in $backends long-double:-DLC_REACTIVITY_TYPE=LC_LONG_DOUBLE; do
+  name=${backend%%:*}
+  $CC -O2 -w -I.. ${backend#*:} -DLC_CHECK_QUEUE $CFLAGS lcbench.c -o lcbench-check-$name -lm || exit 1
+  ./lcbench-check-$name 20000 300 >/dev/null 2>&1 || { echo "lcbench $name: check failed"; exit 1; }
+  rm -f lcbench-check-$name
+done
+
+for backend in $backends; do
+  name=${backend%%:*}
+  $CC -O2 -w -I.. ${backend#*:} $CFLAGS lcbench.c -o lcbench-$name -lm || exit 1
+  for n in $sizes; do
+    # a linear scan of a million events per step takes too long
+    [ "$name" = linear ] && [ "$n" -gt 10000 ] && continue
+    ./lcbench-$name "$steps" "$n" 2>/dev/null
+  done
+  rm -f lcbench-$name
+done
+
+for fast in "" -DLC_FAST_EXPONENT; do
+  $CC -O2 -w -I.. $fast $CFLAGS expbench.c -o expbench -lm || exit 1
+  ./expbench "$steps" || { echo "expbench $fast: class index differs from frexp"; exit 1; }
+done
+rm -f expbench
@@ -0,0 +1,187 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Asynchronous checkpoints, see checkpoint.h.
+
+  The parent keeps the pid and its own count of minor faults at the fork
+  for every child; when the child is collected the difference is, up to
+  the faults of fresh allocations, the number of pages it had to copy.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <checkpoint.h>
+
+static long checkpoint_minflt(void){
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_minflt;
+}
+
+static double checkpoint_seconds(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+void checkpoint_defaults(sm_checkpoint *cp){
+  memset(cp, 0, sizeof(*cp));
+  cp->max_running = 1;
+}
+
+/* child i has ended with status */
+static void checkpoint_done(sm_checkpoint *cp, int i, int status){
+  cp->cow_pages = checkpoint_minflt() - cp->minflt[i];
+  cp->cow_total += cp->cow_pages;
+  if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    cp->written++;
+  else
+    cp->failed++;
+  cp->running--;
+  cp->pid[i]    = cp->pid[cp->running];
+  cp->minflt[i] = cp->minflt[cp->running];
+}
+
+int checkpoint_poll(sm_checkpoint *cp){
+  int i, status;
+
+  for(i = 0; i < cp->running; )
+    if(waitpid(cp->pid[i], &status, WNOHANG) == cp->pid[i])
+      checkpoint_done(cp, i, status);
+    else
+      i++;
+  return cp->running;
+}
+
+size_t checkpoint_wait(sm_checkpoint *cp){
+  int status;
+
+  while(cp->running)
+    if(waitpid(cp->pid[0], &status, 0) == cp->pid[0])
+      checkpoint_done(cp, 0, status);
+    else{
+      cp->failed++;             /* lost, e.g. reaped by someone else */
+      cp->running--;
+      cp->pid[0]    = cp->pid[cp->running];
+      cp->minflt[0] = cp->minflt[cp->running];
+    }
+  return cp->failed;
+}
+
+/*
+** the name of checkpoint number from filename, whose only conversions may
+** be one %lu and any %%; the name is not passed to printf as a format.
+** 0, or -1 with a message if filename has other conversions or the name
+** does not fit into size bytes
+*/
+static int checkpoint_name(char *name, size_t size, const char *filename,
+                           unsigned long number){
+  size_t n=0;
+  int numbered=0, len;
+
+  for(const char *f=filename; *f; f++){
+    if(*f == '%' && f[1] == '%')
+      f++;
+    else if(*f == '%'){
+      if(numbered || f[1] != 'l' || f[2] != 'u'){
+        fprintf(stderr, "checkpoint_start: %s may hold one %%lu and %%%% only\n", filename);
+        return -1;
+      }
+      numbered=1;
+      f+=2;
+      len=snprintf(name+n, n < size ? size-n : 0, "%lu", number);
+      n+=len;
+      continue;
+    }
+    if(n+1 < size)
+      name[n]=*f;
+    n++;
+  }
+  if(n >= size){
+    fprintf(stderr, "checkpoint_start: the name of %s is longer than %zu bytes\n",
+            filename, size-1);
+    return -1;
+  }
+  name[n]=0;
+  return 0;
+}
+
+int checkpoint_start(sm_context *ctx, sm_checkpoint *cp, const char *filename){
+  char name[4096], tmp[4096+32];
+  long minflt;
+  double t;
+  pid_t pid;
+
+  if(ctx->nsm || !ctx->cells)
+    return -1;
+  int limit = cp->max_running < SM_CHECKPOINT_MAX ? cp->max_running : SM_CHECKPOINT_MAX;
+  if(checkpoint_poll(cp) >= (limit > 0 ? limit : 1)){
+    cp->skipped++;
+    return 1;
+  }
+  if(checkpoint_name(name, sizeof(name), filename, (unsigned long) cp->started))
+    return -1;
+
+  minflt = checkpoint_minflt();
+  t = checkpoint_seconds();
+  pid = fork();
+  if(pid == 0){
+    snprintf(tmp, sizeof(tmp), "%s.%ld", name, (long) getpid());
+    _exit(save_state(ctx, tmp) == 0 && rename(tmp, name) == 0 ? 0 : (unlink(tmp), 1));
+  }
+  t = checkpoint_seconds() - t;
+  if(pid < 0){
+    cp->failed++;
+    return -1;
+  }
+
+  cp->pid[cp->running]    = pid;
+  cp->minflt[cp->running] = minflt;
+  cp->running++;
+  cp->started++;
+  cp->pause = t;
+  cp->total_pause += t;
+  if(t > cp->max_pause)
+    cp->max_pause = t;
+  return 0;
+}
+
+size_t checkpoint_walk_until(sm_context *ctx, double time, double every,
+                             const char *filename, sm_checkpoint *cp){
+  double next = (floor(ctx->markov_time/every) + 1)*every;
+  size_t steps = 0, s;
+
+  while(ctx->markov_time < time){
+    s = run_walk_until(ctx, next < time ? next : time);
+    if(s == (size_t) -1)
+      return steps ? steps : s;
+    steps += s;
+    if(ctx->markov_time >= next){
+      checkpoint_start(ctx, cp, filename);
+      while(next <= ctx->markov_time)
+        next += every;
+    }
+    else if(!s)
+      break;                    /* no cell can fire any more */
+  }
+  return steps;
+}
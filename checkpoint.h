@@ -0,0 +1,66 @@
+#ifndef __CHECKPOINT_H___
+#define __CHECKPOINT_H___
+
+#include <sys/types.h>
+#include <sagemarkov.h>
+
+/*
+** Asynchronous checkpoints by fork.
+**
+** checkpoint_start forks at the current step boundary; the child writes
+** the walk by save_state and exits, while the parent steps on. The pages
+** of the lattice are shared copy-on-write, the parent stands still only
+** for the fork, i.e. for copying its page tables, and pays later for each
+** page it writes to while a child still holds it.
+**
+** The file is written to <name>.<pid> and renamed when complete, a reader
+** never sees a half written checkpoint. filename may hold one %lu, which
+** becomes the number of the checkpoint; with max_running above 1 it
+** should, else an older child finishing late may replace a newer state.
+** Any other % has to be written %%, the name is not a printf format.
+**
+** No other thread should run when the process forks, e.g. an ensemble.
+*/
+#define SM_CHECKPOINT_MAX 16
+
+typedef struct SM_CHECKPOINT{
+  /* set by the user, see checkpoint_defaults */
+  int max_running;              /* children at a time, <= SM_CHECKPOINT_MAX */
+
+  /* maintained by checkpoint_start and checkpoint_poll */
+  int running;
+  pid_t pid[SM_CHECKPOINT_MAX];
+  long minflt[SM_CHECKPOINT_MAX]; /* parent's minor faults at the fork   */
+  size_t started, written, failed, skipped;
+  double pause, max_pause, total_pause; /* seconds the parent was in fork */
+  long cow_pages;               /* minor faults of the parent while the
+                                   last checkpoint finished was written,
+                                   mostly pages copied on write          */
+  long cow_total;
+} sm_checkpoint;
+
+/* max_running 1, all counters 0 */
+void checkpoint_defaults(sm_checkpoint *cp);
+
+/*
+** forks a child writing ctx to filename. Returns 0 if started, 1 if
+** max_running children are still busy and it was skipped, -1 if the
+** fork failed, ctx runs the next-subvolume engine, see save_state, or
+** filename has other conversions than %lu and %% or is too long.
+*/
+int checkpoint_start(sm_context *ctx, sm_checkpoint *cp, const char *filename);
+
+/* collects the children finished, returns the number still running */
+int checkpoint_poll(sm_checkpoint *cp);
+
+/* waits for all children, returns the number of failed checkpoints */
+size_t checkpoint_wait(sm_checkpoint *cp);
+
+/*
+** runs ctx until time like run_walk_until and starts a checkpoint at the
+** first step boundary after every multiple of every; returns the steps
+*/
+size_t checkpoint_walk_until(sm_context *ctx, double time, double every,
+                             const char *filename, sm_checkpoint *cp);
+
+#endif
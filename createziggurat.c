@@ -0,0 +1,110 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+** createziggurat: writes the tables of the ziggurat samplers in rand55.c
+**
+**   gcc -O2 createziggurat.c -o createziggurat -lm
+**   ./createziggurat > ziggurat55static.c
+**
+** Marsaglia and Tsang, The Ziggurat Method for Generating Random
+** Variables, J. Stat. Software 5 (2000). The density f, exp(-x) with 256
+** layers or exp(-x*x/2) with 128, is covered by layers of equal area v.
+** x[1] = r is the start of the tail, x[i+1] follows from
+** v = x[i] * (f(x[i+1]) - f(x[i])), the base layer 0 is a rectangle of
+** width x[0] = v/f(r) including the tail. r is found by bisection so
+** that the top layer ends at f(0) = 1.
+**
+** For a draw u = rand55() the layer is the top bits, j the low 56 bits:
+**   k[i] = 2^56 x[i+1]/x[i]   j < k[i]: x = j w[i] lies in the layer
+**   w[i] = x[i]/2^56
+**   f[i] = f(x[i]), f[N] = 1  the wedge test between f[i] and f[i+1]
+*/
+
+#include <stdio.h>
+#include <math.h>
+
+typedef long double real;
+
+static real f_exp(real x)     { return expl(-x); }
+static real finv_exp(real y)  { return -logl(y); }
+static real tail_exp(real r)  { return expl(-r); }
+
+static real f_gauss(real x)    { return expl(-x*x/2); }
+static real finv_gauss(real y) { return sqrtl(-2*logl(y)); }
+static real tail_gauss(real r) { return sqrtl(M_PI/2) * erfcl(r/sqrtl(2)); }
+
+/* fill x[0..n], return how far the top layer misses f(0) = 1 */
+static real layers(int n, real r, real *x, real *v,
+                   real (*f)(real), real (*finv)(real), real (*tail)(real))
+{
+  int i;
+  real y;
+
+  *v   = r*f(r) + tail(r);
+  x[0] = *v/f(r);
+  x[1] = r;
+  for (i = 1; i < n-1; i++) {
+    y = *v/x[i] + f(x[i]);
+    if (y >= 1)             /* layers too high, r too small */
+      return 1;
+    x[i+1] = finv(y);
+  }
+  x[n] = 0;
+  return *v/x[n-1] + f(x[n-1]) - 1;
+}
+
+static void table(const char *name, int n, real lo, real hi,
+                  real (*f)(real), real (*finv)(real), real (*tail)(real))
+{
+  real x[257], v, r = 0;
+  int i, it;
+
+  for (it = 0; it < 200; it++) {
+    r = (lo + hi)/2;
+    if (layers(n, r, x, &v, f, finv, tail) > 0)
+      lo = r;
+    else
+      hi = r;
+  }
+  layers(n, r, x, &v, f, finv, tail);
+
+  printf("\n/* %s: %d layers, r = %.17Lg, v = %.17Lg */\n", name, n, r, v);
+  printf("const double rand55_z%s_r = %.17Lg;\n", name, r);
+  printf("const rand55_t rand55_z%s_k[%d] = {", name, n);
+  for (i = 0; i < n; i++)
+    printf("%s%lluUL", !i ? "\n  " : i % 4 ? ", " : ",\n  ",
+           (unsigned long long)floorl(ldexpl(x[i+1]/x[i], 56)));
+  printf("};\n");
+  printf("const double rand55_z%s_w[%d] = {", name, n);
+  for (i = 0; i < n; i++)
+    printf("%s%.17Lg", !i ? "\n  " : i % 3 ? ", " : ",\n  ", ldexpl(x[i], -56));
+  printf("};\n");
+  printf("const double rand55_z%s_f[%d] = {", name, n+1);
+  for (i = 0; i <= n; i++)
+    printf("%s%.17Lg", !i ? "\n  " : i % 3 ? ", " : ",\n  ", i < n ? f(x[i]) : 1.0L);
+  printf("};\n");
+}
+
+int main(void)
+{
+  printf("/* generated by createziggurat.c, do not edit */\n");
+  printf("#include \"rand55.h\"\n");
+  table("exp",   256, 1, 20, f_exp,   finv_exp,   tail_exp);
+  table("gauss", 128, 1, 10, f_gauss, finv_gauss, tail_gauss);
+  return 0;
+}
@@ -10,6 +10,4 @@ typedef struct CELL{
   int n;
 } cell;
 
-cell * cells;
-
 #endif 
\ No newline at end of file
@@ -14,8 +14,8 @@ lc_reactivity_t diffusion_reactivity(const cell* source){
     return diffusion_rate * source->n;
 };
 
-lc_reactivity_t reactivity(size_t index) {
-    return LC_REACTIVITY(cells+index);
+lc_reactivity_t reactivity(const sm_context *ctx, size_t index) {
+    return LC_REACTIVITY(ctx->cells+index);
 }
 
 lc_reactivity_t LC_REACTIVITY(const cell* source) {
@@ -26,13 +26,31 @@ void reaction_step(cell * source){
     source -> n--;
 };
 
-cell * diffusion_step(cell * source){
+cell * diffusion_step(sm_context *ctx, cell * source){
     source->n--;
 
-    cell *dest = random_neighbour(source);
+    cell *dest = random_neighbour(ctx, source);
     dest->n++;
 
     return dest;
    };
 
+unsigned long population(const cell* source){
+    return source->n;
+}
+
+unsigned long species(const cell* source, int s){
+    (void) s;
+    return source->n;
+}
+
+void reaction_leap(cell * source, unsigned long k){
+    source->n -= k;
+}
+
+void diffusion_leap(cell * source, cell * dest, unsigned long k){
+    source->n -= k;
+    dest->n   += k;
+}
+
 #endif
@@ -18,6 +18,7 @@
 #define __MODEL_H__
 #include <logclass.h>
 #include <diffusion/cells.h>
+#include <randomwalk.h>
 
 lc_reactivity_t decay_rate, diffusion_rate;
 
@@ -27,12 +28,24 @@ lc_reactivity_t reaction_reactivity(const cell* source);
 lc_reactivity_t diffusion_reactivity(const cell* source);
 
 
-lc_reactivity_t reactivity(size_t index);
+lc_reactivity_t reactivity(const sm_context *ctx, size_t index);
 
 lc_reactivity_t LC_REACTIVITY( const cell* source );
 
 void reaction_step(cell * source);
 
-cell * diffusion_step(cell * source);
+cell * diffusion_step(sm_context *ctx, cell * source);
+
+/* for leaping: walkers in a cell, k reactions, k walkers moved to dest */
+unsigned long population(const cell* source);
+
+void reaction_leap(cell * source, unsigned long k);
+
+void diffusion_leap(cell * source, cell * dest, unsigned long k);
+
+/* for the moments: kinds of walkers, the walkers of kind s in a cell */
+#define SM_SPECIES 1
+
+unsigned long species(const cell* source, int s);
 
 #endif
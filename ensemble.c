@@ -0,0 +1,243 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Thread-parallel runner for ensembles of independent replicas.
+
+  Every thread takes a contiguous block of replicas and runs them one
+  after the other in a private sm_context, accumulating means and second
+  moments by Welford's method.  After all threads joined, the partial
+  results are merged in thread order (Chan et al.), so the result does
+  not depend on the scheduling.
+*/
+
+#include <pthread.h>
+#include <unistd.h>
+#include <string.h>
+#include <ensemble.h>
+
+typedef struct ENSEMBLE_WORKER{
+  sm_ensemble *e;
+  size_t first, last;               /* replicas first .. last-1       */
+  size_t count;                     /* replicas finished              */
+  double *series_mean, *series_m2;
+  double *cell_mean, *cell_m2;
+  size_t steps;
+  pthread_t thread;
+} ensemble_worker;
+
+unsigned long ensemble_seed(unsigned long seed, size_t replica){
+  /* replica r runs on stream r of the master seed */
+  return rand55_stream_seed(seed, replica);
+}
+
+static void ensemble_add(double *mean, double *m2, size_t n, double x){
+  double delta = x - *mean;
+  *mean += delta / n;
+  *m2   += delta * ( x - *mean );
+}
+
+static void ensemble_merge(double *mean, double *m2, size_t na,
+                           const double *mean_b, const double *m2_b, size_t nb,
+                           size_t size){
+  size_t n=na+nb;
+  if(!nb)
+    return;
+  for(size_t i=0; i<size; i++){
+    double delta = mean_b[i] - mean[i];
+    mean[i] += delta * nb / n;
+    m2[i]   += m2_b[i] + delta * delta * ( (double) na * nb / n );
+  }
+}
+
+static void *ensemble_thread(void *arg){
+  ensemble_worker *w=(ensemble_worker*) arg;
+  sm_ensemble *e=w->e;
+  const size_t no=e->number_of_observables;
+  const double *row;
+  sm_recorder rec;
+  sm_context ctx;
+
+  for(size_t replica=w->first; replica<w->last; replica++){
+    memset(&ctx, 0, sizeof(ctx));
+    if(create_walk_seeded(&ctx, e->topology, e->number_of_cells,
+                          ensemble_seed(e->seed, replica), e->timescale, e->seeding)){
+      e->failed[replica]=1;
+      continue;
+    }
+    if(e->initial && e->initial(&ctx, e->initial_arg)){
+      e->failed[replica]=1;
+      destroy_walk(&ctx);
+      continue;
+    }
+    /* sampled before the event that passes a time fires, see recorder.h */
+    memset(&rec, 0, sizeof(rec));
+    int error=e->number_of_times
+              && recorder_create_times(&rec, e->times, e->number_of_times);
+    for(size_t o=0; !error && e->number_of_times && o<no; o++)
+      error=recorder_function(&rec, e->observables[o]) < 0;
+    if(error || (e->number_of_times && recorder_attach(&ctx, &rec))){
+      e->failed[replica]=1;
+      recorder_destroy(&rec);
+      destroy_walk(&ctx);
+      continue;
+    }
+    w->count++;
+
+    /* times before the start are skipped by the recorder, they see the
+       state at the start */
+    for(size_t t=0; t<rec.sampled; t++)
+      for(size_t o=0; o<no; o++)
+        ensemble_add(w->series_mean+t*no+o, w->series_m2+t*no+o, w->count,
+                     e->observables[o](&ctx));
+    if(e->number_of_times){
+      const double last=e->times[e->number_of_times-1];
+      size_t steps=run_walk_until(&ctx, last);
+      if(steps != (size_t) -1)
+        w->steps+=steps;
+      /* a walk that cannot fire holds its state up to last */
+      if(ctx.record_at <= last)
+        recorder_sample(&ctx, nextafter(last, INFINITY));
+    }
+    recorder_detach(&ctx);
+    row=recorder_data(&rec);
+    for(size_t t=e->number_of_times-rec.rows; t<e->number_of_times; t++, row+=no)
+      for(size_t o=0; o<no; o++)
+        ensemble_add(w->series_mean+t*no+o, w->series_m2+t*no+o, w->count,
+                     row[o]);
+    recorder_destroy(&rec);
+
+    if(e->cell_observable)
+      for(size_t i=0; i<e->number_of_cells; i++)
+        ensemble_add(w->cell_mean+i, w->cell_m2+i, w->count,
+                     e->cell_observable(ctx.cells+i));
+
+    destroy_walk(&ctx);
+  }
+  return NULL;
+}
+
+void destroy_ensemble(sm_ensemble *e){
+  free(e->series_mean);
+  free(e->series_var);
+  free(e->cell_mean);
+  free(e->cell_var);
+  free(e->failed);
+  e->series_mean=e->series_var=e->cell_mean=e->cell_var=NULL;
+  e->failed=NULL;
+  e->failures=0;
+}
+
+int run_ensemble(sm_ensemble *e){
+  const size_t series=e->number_of_times*e->number_of_observables;
+  const size_t cells=e->cell_observable ? e->number_of_cells : 0;
+  ensemble_worker *w;
+  int threads=e->threads, t, error=0;
+  size_t n;
+
+  if(threads<1)
+    threads=(int) sysconf(_SC_NPROCESSORS_ONLN);
+  if(threads<1)
+    threads=1;
+  if((size_t) threads>e->replicas)
+    threads=e->replicas ? (int) e->replicas : 1;
+
+  /* all replicas derive their streams from the same master seed */
+  if(e->seed==0)
+    e->seed=time(NULL) | 1;
+
+  destroy_ensemble(e);
+  e->steps=0;
+
+  e->failed=calloc(e->replicas+1, 1);
+  w=calloc(threads, sizeof(ensemble_worker));
+  if(!w || !e->failed){
+    free(w);
+    return -1;
+  }
+
+  for(t=0; t<threads; t++){
+    w[t].e=e;
+    w[t].first=e->replicas*t/threads;
+    w[t].last =e->replicas*(t+1)/threads;
+    w[t].series_mean=calloc(series+1, sizeof(double));
+    w[t].series_m2  =calloc(series+1, sizeof(double));
+    w[t].cell_mean  =calloc(cells+1, sizeof(double));
+    w[t].cell_m2    =calloc(cells+1, sizeof(double));
+    if(!w[t].series_mean || !w[t].series_m2 || !w[t].cell_mean || !w[t].cell_m2)
+      error=-1;
+  }
+
+  for(t=0; !error && t<threads; t++)
+    if(pthread_create(&w[t].thread, NULL, ensemble_thread, w+t)){
+      fprintf(stderr, "run_ensemble: could not start thread %d\n", t);
+      error=-1;
+      break;
+    }
+  /* join what has been started, even if starting the rest failed */
+  while(t--)
+    pthread_join(w[t].thread, NULL);
+
+  if(!error){
+    for(size_t r=0; r<e->replicas; r++)
+      e->failures+=e->failed[r];
+    if(e->failures){
+      fprintf(stderr, "run_ensemble: %zu of %zu replicas failed\n",
+              e->failures, e->replicas);
+      error=-1;
+    }
+
+    /* merge in thread order into the first worker */
+    n=w[0].count;
+    e->steps=w[0].steps;
+    for(t=1; t<threads; t++){
+      ensemble_merge(w[0].series_mean, w[0].series_m2, n,
+                     w[t].series_mean, w[t].series_m2, w[t].count, series);
+      ensemble_merge(w[0].cell_mean, w[0].cell_m2, n,
+                     w[t].cell_mean, w[t].cell_m2, w[t].count, cells);
+      n+=w[t].count;
+      e->steps+=w[t].steps;
+    }
+
+    /* sample variances, the m2 arrays are turned into them in place */
+    for(size_t i=0; i<series; i++)
+      w[0].series_m2[i] = n>1 ? w[0].series_m2[i]/(n-1) : 0;
+    for(size_t i=0; i<cells; i++)
+      w[0].cell_m2[i] = n>1 ? w[0].cell_m2[i]/(n-1) : 0;
+
+    e->series_mean=w[0].series_mean;
+    e->series_var =w[0].series_m2;
+    if(cells){
+      e->cell_mean=w[0].cell_mean;
+      e->cell_var =w[0].cell_m2;
+    } else {
+      free(w[0].cell_mean);
+      free(w[0].cell_m2);
+    }
+    t=1;
+  } else
+    t=0;
+
+  for(; t<threads; t++){
+    free(w[t].series_mean);
+    free(w[t].series_m2);
+    free(w[t].cell_mean);
+    free(w[t].cell_m2);
+  }
+  free(w);
+  return error;
+}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __ENSEMBLE_H___
+#define __ENSEMBLE_H___
+
+#include <recorder.h>
+
+/*
+** Ensemble of independent replicas of one model.
+**
+** The replicas are distributed over a pool of threads, every replica runs
+** in its own sm_context with its own random stream, all of them share the
+** topology. Observables are sampled at the given ascending times by a
+** recorder, each sees the state at its time, see recorder.h, and the
+** per cell observable once the walk passed the last time, means and
+** variances are merged over all replicas.
+*/
+
+typedef double (*sm_cell_observable)(const cell *c);
+typedef int    (*sm_initial)(sm_context *ctx, void *arg);  /* 0, else failed */
+
+typedef struct SM_ENSEMBLE{
+  /* set by the user */
+  const sm_topology *topology;
+  size_t number_of_cells;
+  double timescale;
+  unsigned long seed;           /* master seed, 0 takes the clock         */
+  int seeding;                  /* of the replicas, SM_SEED_DEFAULT or
+                                   SM_SEED_HASH, see sagemarkov.h         */
+  size_t replicas;
+  int threads;                  /* 0 uses one thread per online core      */
+  sm_initial initial;           /* sets the initial conditions of a replica */
+  void *initial_arg;
+  size_t number_of_times;
+  const double *times;
+  size_t number_of_observables;
+  const sm_observable *observables;
+  sm_cell_observable cell_observable;   /* may be NULL */
+
+  /* results, allocated by run_ensemble, freed by destroy_ensemble */
+  double *series_mean, *series_var;     /* [time*number_of_observables+observable] */
+  double *cell_mean, *cell_var;         /* [cell]                       */
+  size_t steps;                         /* markov steps of all replicas */
+  unsigned char *failed;                /* [replica], 1 if its walk could
+                                           not be created or initial
+                                           returned nonzero             */
+  size_t failures;                      /* replicas failed              */
+} sm_ensemble;
+
+/*
+** runs all replicas, returns 0 on success, -1 if memory or threads
+** could not be allocated or a replica failed; the means and variances
+** are then those of the replicas that ran, failed tells which did not
+*/
+int run_ensemble(sm_ensemble *e);
+
+void destroy_ensemble(sm_ensemble *e);
+
+/* the seed replica number replica is started with */
+unsigned long ensemble_seed(unsigned long seed, size_t replica);
+
+#endif
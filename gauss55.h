@@ -21,15 +21,13 @@
 #define rand55_N_GAUSSHALF 32
 #include "rand55.h"
 
-extern short rand55_j, rand55_0j ;
-extern short rand55_k, rand55_0k ;
-
 
 extern int 	rand55_g_else[rand55_N_GAUSS];
 extern double 	rand55_g_prob[rand55_N_GAUSS];
 extern double 	rand55_gauss_reject[rand55_N_GAUSSHALF];
 
-extern rand55_t rand55_s [ rand55_K ], rand55_0s [ rand55_K ] ;
+extern rand55_state rand55_g ;
+extern rand55_t rand55_0s [ rand55_K ] ;
 
 
 #endif
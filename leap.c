@@ -0,0 +1,255 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Spatial tau-leaping and multinomial diffusion splitting, see leap.h.
+
+  Between leaps ctx->lc holds the critical cells only, the others are
+  removed from it, so LC_TIME_STEP and markov_step see the exact part of
+  the system. Before exact steps and on return all cells are entered
+  again. A leap whose counts would take more walkers out of a cell than
+  it holds is rejected and tau halved.
+
+  The counts of the cells in a sweep are drawn through sweep_cell, under
+  RAND55_PHILOX each cell from its own stream.
+
+  An attached recorder is not sampled while leaping or splitting,
+  record_at is put aside, the times passed become NAN rows. The walker
+  moments are not followed, they are counted again when next read.
+*/
+
+#include <math.h>
+#include <leap.h>
+
+/* the cell in ctx->lc with its reactivity, or out of it */
+static void leap_enter(sm_context *ctx, cell *c, int exact){
+  c->lc_ev=lc_safechange(&ctx->lc, c->lc_ev, c,
+                         exact ? (lc_reactivity_t) LC_REACTIVITY(c) : 0);
+}
+
+void leap_defaults(sm_leap *leap){
+  leap->epsilon=0.03;
+  leap->critical=10;
+  leap->min_events=100;
+  leap->exact_steps=1000;
+  leap->leaps=leap->exact=leap->rejected=0;
+}
+
+size_t leap_walk_until(sm_context *ctx, double time, sm_leap *leap){
+  const size_t n=ctx->number_of_cells;
+  const size_t neighbours=2*ctx->topology->dimension;
+  const double ts=ctx->timescale;
+  unsigned long *kr, *kd;
+  unsigned char *critical;
+  size_t step=0;
+  double record_at;
+  sm_sweep sweep;
+
+  nsm_stop(ctx);
+  for(size_t i=0; i<n; i++)
+    leap_enter(ctx, ctx->cells+i, 1);
+  if( ctx->lc.r < LC_EPS(&ctx->lc) )
+    return -1;
+
+  kr=calloc(n+1, sizeof(unsigned long));
+  kd=calloc(n+1, sizeof(unsigned long));
+  critical=calloc(n+1, 1);
+  if(!kr || !kd || !critical){
+    free(kr);
+    free(kd);
+    free(critical);
+    return -1;
+  }
+  record_at=ctx->record_at;
+  ctx->record_at=INFINITY;
+
+  while(ctx->markov_time < time){
+    double tau=INFINITY, a=0;
+    int fire=0;
+
+    /* critical cells stay in lc, tau bounds the outflow of the others */
+    for(size_t i=0; i<n; i++){
+      cell *c=ctx->cells+i;
+      unsigned long pop=population(c);
+      double r=(double) LC_REACTIVITY(c);
+
+      critical[i]= pop < leap->critical;
+      leap_enter(ctx, c, critical[i]);
+      if(!critical[i] && r > 0){
+        double g=leap->epsilon*pop;
+        a+=r;
+        tau=fmin(tau, ts*(g > 1 ? g : 1)/r);
+      }
+    }
+    if(a == 0 && ctx->lc.r <= LC_EPS(&ctx->lc))
+      break;
+
+    if(a*tau/ts < leap->min_events){
+      /* not worth a leap, step exactly for a while */
+      for(size_t i=0; i<n; i++)
+        if(!critical[i])
+          leap_enter(ctx, ctx->cells+i, 1);
+      for(size_t s=0; s<leap->exact_steps && ctx->markov_time < time
+                      && ctx->lc.r > LC_EPS(&ctx->lc); s++){
+        ctx->markov_time+=markov_step(ctx);
+        step++;
+        leap->exact++;
+      }
+      continue;
+    }
+
+    if(tau > time-ctx->markov_time)
+      tau=time-ctx->markov_time;
+    if(ctx->lc.r > LC_EPS(&ctx->lc)){
+      double tc=LC_TIME_STEP_IN(&ctx->lc);
+      if(tc < tau){
+        tau=tc;
+        fire=1;
+      }
+    }
+
+    /* draw all counts from the state at the beginning of the leap */
+    sweep_start(ctx, &sweep);
+    for(size_t i=0; i<n; i++){
+      cell *c=ctx->cells+i;
+      rand55_state *rng;
+      if(critical[i])
+        continue;
+      rng=sweep_cell(&sweep, i);
+      kr[i]=poisson_rand55_r(rng, (double) reaction_reactivity(c)*tau/ts);
+      kd[i]=poisson_rand55_r(rng, (double) diffusion_reactivity(c)*tau/ts);
+      if(kr[i]+kd[i] > population(c)){
+        tau/=2;
+        fire=0;
+        leap->rejected++;
+        sweep_start(ctx, &sweep);
+        i=(size_t) -1;   /* start over */
+      }
+    }
+
+    sweep_start(ctx, &sweep);
+    for(size_t i=0; i<n; i++){
+      cell *c=ctx->cells+i;
+      unsigned long left=kd[i];
+      rand55_state *rng;
+      if(critical[i])
+        continue;
+      reaction_leap(c, kr[i]);
+      rng=sweep_cell(&sweep, i);
+      for(size_t j=0; left && j<neighbours; j++){
+        unsigned long k = j+1 < neighbours ? binomial_rand55_r(rng, left, 1.0/(neighbours-j)) : left;
+        diffusion_leap(c, neighbour(ctx, c, j), k);
+        left-=k;
+      }
+    }
+    ctx->markov_time+=tau;
+    step++;
+    leap->leaps++;
+
+    if(fire){
+      /* critical cells may have got walkers during the leap */
+      for(size_t i=0; i<n; i++)
+        if(critical[i])
+          leap_enter(ctx, ctx->cells+i, 1);
+      if(ctx->lc.r > LC_EPS(&ctx->lc)){
+        markov_step(ctx);   /* its time step has been drawn as tc */
+        step++;
+        leap->exact++;
+      }
+    }
+  }
+
+  for(size_t i=0; i<n; i++)
+    leap_enter(ctx, ctx->cells+i, 1);
+  ctx->record_at=record_at;
+  moments_invalidate(ctx);
+  free(kr);
+  free(kd);
+  free(critical);
+  return step;
+}
+
+/* the cell in ctx->lc with its reaction reactivity only */
+static void split_enter(sm_context *ctx, cell *c){
+  c->lc_ev=lc_safechange(&ctx->lc, c->lc_ev, c, reaction_reactivity(c));
+}
+
+size_t split_walk_until(sm_context *ctx, double time, double window){
+  const size_t n=ctx->number_of_cells;
+  const size_t neighbours=2*ctx->topology->dimension;
+  const double ts=ctx->timescale;
+  unsigned long *out;
+  size_t windows=0;
+  double record_at=ctx->record_at;
+  sm_sweep sweep;
+
+  out=calloc(n+1, sizeof(unsigned long));
+  if(!out)
+    return -1;
+  nsm_stop(ctx);
+  for(size_t i=0; i<n; i++)
+    split_enter(ctx, ctx->cells+i);
+  ctx->record_at=INFINITY;
+
+  while(ctx->markov_time < time){
+    double h = time-ctx->markov_time < window ? time-ctx->markov_time : window;
+    double end=ctx->markov_time+h, t=ctx->markov_time;
+
+    /* reactions, exact; the step beyond the window is discarded */
+    while(ctx->lc.r > LC_EPS(&ctx->lc)){
+      t+=LC_TIME_STEP_IN(&ctx->lc);
+      if(t >= end)
+        break;
+      LC_DRAW_IN(&ctx->lc, cell, source);
+      reaction_step(source);
+      source->lc_ev=lc_knownchange(&ctx->lc, lc_c, lc_e, source,
+                                   reaction_reactivity(source));
+    }
+
+    /* walkers leaving each cell, all from the state before the sweep */
+    sweep_start(ctx, &sweep);
+    for(size_t i=0; i<n; i++){
+      cell *c=ctx->cells+i;
+      unsigned long pop=population(c);
+      double p = pop ? (double) diffusion_reactivity(c)/pop*h/ts : 0;
+      out[i] = pop ? binomial_rand55_r(sweep_cell(&sweep, i), pop, p < 1 ? p : 1) : 0;
+    }
+    sweep_start(ctx, &sweep);
+    for(size_t i=0; i<n; i++){
+      cell *c=ctx->cells+i;
+      unsigned long left=out[i];
+      rand55_state *rng=sweep_cell(&sweep, i);
+      for(size_t j=0; left && j<neighbours; j++){
+        unsigned long k = j+1 < neighbours ? binomial_rand55_r(rng, left, 1.0/(neighbours-j)) : left;
+        diffusion_leap(c, neighbour(ctx, c, j), k);
+        left-=k;
+      }
+    }
+    for(size_t i=0; i<n; i++)
+      split_enter(ctx, ctx->cells+i);
+
+    ctx->markov_time=end;
+    windows++;
+  }
+
+  for(size_t i=0; i<n; i++)
+    leap_enter(ctx, ctx->cells+i, 1);
+  ctx->record_at=record_at;
+  moments_invalidate(ctx);
+  free(out);
+  return windows;
+}
@@ -0,0 +1,61 @@
+#ifndef __LEAP_H___
+#define __LEAP_H___
+
+#include <sagemarkov.h>
+
+/*
+** Spatial tau-leaping on top of the logclass engine.
+**
+** A leap advances every cell whose population is at least critical by
+** Poisson counts of reaction and diffusion events over tau, the diffusing
+** walkers are split over the 2*dimension neighbours by binomial draws.
+** tau is chosen so the expected outflow of no such cell exceeds
+** epsilon times its population (at least one walker). Cells below critical
+** stay in ctx->lc and are stepped exactly: if their next event comes
+** before the end of the leap, the leap is shortened to it and the event
+** is fired by markov_step. If a leap would cover fewer than min_events
+** events, exact_steps steps of markov_step are done instead.
+**
+** The model has to provide population, reaction_leap and diffusion_leap
+** besides the functions of markov_step. The result is approximate,
+** epsilon trades accuracy for speed.
+*/
+typedef struct SM_LEAP{
+  /* set by the user, see leap_defaults */
+  double epsilon;               /* relative change of a cell per leap     */
+  unsigned long critical;       /* cells below are stepped exactly        */
+  double min_events;            /* shorter leaps are done exactly         */
+  size_t exact_steps;           /* markov steps before leaping again      */
+
+  /* counted by leap_walk_until */
+  size_t leaps, exact, rejected;
+} sm_leap;
+
+/* epsilon 0.03, critical 10, min_events 100, exact_steps 1000 */
+void leap_defaults(sm_leap *leap);
+
+/*
+** runs ctx until time like run_walk_until, returns the number of leaps
+** and exact steps, -1 if no cell can fire or memory is short.
+** The next-subvolume engine is stopped first.
+*/
+size_t leap_walk_until(sm_context *ctx, double time, sm_leap *leap);
+
+/*
+** Multinomial diffusion splitting (lattice RDME).
+**
+** Time is cut into windows. Within a window the reactions alone run
+** exactly on ctx->lc, holding reaction_reactivity of every cell. At its
+** end every cell lets each walker hop with probability window*rate, rate
+** the diffusion reactivity per walker, and the hopping walkers are split
+** over the 2*dimension neighbours by one multinomial draw. The mean number
+** of hops, and so the mean square displacement, is that of the exact
+** process. The diffusion reactivity has to be linear in the population
+** and window*rate below 1, a walker hops at most once per window.
+**
+** Runs ctx until time, returns the number of windows, -1 if memory is
+** short. The next-subvolume engine is stopped first.
+*/
+size_t split_walk_until(sm_context *ctx, double time, double window);
+
+#endif
@@ -56,6 +56,9 @@ char *lc_types[]={0,
        lc_rand
        lc_knownchange
        lc_safechange
+       lc_update_batch
+       lc_stats
+       lc_stats_dump
      which constitute the user interface of the lc package
 
    - Private function definitions:
@@ -91,7 +94,7 @@ static void lc_print_queue(lc_global * lc_g, char * s){
 	printf("%s\n",s);
 	for(class_i=lc_g->first; class_i; class_i=class_i->next){
 		printf("%d.r=%f  #%d, p=%d n=%d\n",
-			class_i-lc_g->cbeg,class_i->r,class_i->top-class_i->bot,
+			class_i-lc_g->cbeg,class_i->r,LC_CLASS_SIZE(class_i),
 			class_i->prev-lc_g->cbeg,class_i->next-lc_g->cbeg);
 	}
 	printf("------------\n");
@@ -116,7 +119,7 @@ static void lc_check_queue(lc_global * lc_g, char * s){
 	}
 	
 	double error=abs(lc_g->r-r)/r;
-	static double rel_error=0;
+	static __thread double rel_error=0;   /* per thread, contexts may run in parallel */
 	
 	if(error>rel_error){
 		rel_error=error;
@@ -126,7 +129,272 @@ static void lc_check_queue(lc_global * lc_g, char * s){
 	}
 
 }
+#ifdef LC_CHECK_QUEUE
+/* -DLC_CHECK_QUEUE: no led of reactivity 0 may stay in a class, in all
+   backends; O(events) per call. The class sums are not compared, a
+   check may come between the change of a class and of its leds */
+static void lc_check_events(lc_global * lc_g, char * s){
+	lc_class * cd;
+	size_t i;
+
+#ifndef LC_CLASS_TREE
+	lc_check_queue(lc_g, s);
+#endif
+	for(cd=lc_g->cbeg; cd<lc_g->cend; cd++)
+		for(i=0; i<LC_CLASS_SIZE(cd); i++)
+			if(!(LC_CLASS_LED(cd,i)->r > 0)){
+				printf("%s: stale led %zu of class %d, r=%g\n", s, i,
+				       (int)(cd-lc_g->cbeg), (double)LC_CLASS_LED(cd,i)->r);
+				exit(1);
+			}
+}
+#undef LC_CHECK_QUEUE
+#define LC_CHECK_QUEUE(lc,s) lc_check_events((lc),(s))
+#elif defined(LC_CLASS_TREE)
+#define LC_CHECK_QUEUE(lc,s)  /* there is no list of classes to check */
+#else
 #define LC_CHECK_QUEUE(lc,s) lc_check_queue((lc),(s))
+#endif
+
+#ifdef LC_CLASS_TREE
+
+#define LC_BITS ((int)(sizeof(unsigned long)*CHAR_BIT))
+
+/* add dr to the reactivity of class cd in the Fenwick tree */
+static void lc_tree_add(lc_global *lc, lc_class *cd, lc_reactivity_t dr){
+    size_t i;
+    for( i = cd - lc->cbeg + 1; i <= (size_t) lc->num_classes; i += i & -i )
+        lc->class_tree[i] += dr;
+}
+
+/* rebuild the tree from the class reactivities in O(num_classes) */
+static void lc_tree_build(lc_global *lc){
+    size_t i, j, n=lc->num_classes;
+    for( i = 1; i <= n; i++ )
+        lc->class_tree[i] = lc->cbeg[i-1].r;
+    for( i = 1; i <= n; i++ ) {
+        j = i + ( i & -i );
+        if( j <= n )
+            lc->class_tree[j] += lc->class_tree[i];
+    }
+}
+
+static void lc_bits_set(lc_global *lc, lc_class *cd){
+    size_t ci = cd - lc->cbeg;
+    lc->class_bits[ci/LC_BITS] |= 1UL << (ci%LC_BITS);
+    lc->occupied_classes++;
+}
+
+static void lc_bits_clear(lc_global *lc, lc_class *cd){
+    size_t ci = cd - lc->cbeg;
+    lc->class_bits[ci/LC_BITS] &= ~(1UL << (ci%LC_BITS));
+    lc->occupied_classes--;
+}
+
+/* occupied class next to index ci, looking downward first */
+static lc_class *lc_bits_nearest(lc_global *lc, size_t ci){
+    long w, words=(lc->num_classes+LC_BITS-1)/LC_BITS;
+    unsigned long b;
+
+    if( ci >= (size_t) lc->num_classes )
+        ci = lc->num_classes-1;
+    w = ci/LC_BITS;
+    b = lc->class_bits[w] & ( ~0UL >> (LC_BITS-1-ci%LC_BITS) );
+    for( ; !b && w > 0 ; )
+        b = lc->class_bits[--w];
+    if( b )
+        return lc->cbeg + w*LC_BITS + (LC_BITS-1-__builtin_clzl(b));
+
+    for( w = ci/LC_BITS; w < words; w++ )
+        if( lc->class_bits[w] )
+            return lc->cbeg + w*LC_BITS + __builtin_ctzl(lc->class_bits[w]);
+    return NULL;
+}
+
+/* class containing the prefix sum r, by descending the Fenwick tree */
+static lc_class *lc_tree_find(lc_global *lc, lc_reactivity_t r){
+    size_t pos=0, step;
+    lc_class *cd;
+
+    for( step = lc->class_tree_step; step; step >>= 1 )
+        if( pos + step <= (size_t) lc->num_classes && lc->class_tree[pos+step] <= r ) {
+            pos += step;
+            r   -= lc->class_tree[pos];
+        }
+    /* round-off errors may point just beside the occupied classes */
+    cd = lc->cbeg + pos;
+    if( pos >= (size_t) lc->num_classes || !LC_CLASS_SIZE(cd) )
+        cd = lc_bits_nearest(lc, pos);
+    return cd;
+}
+
+#define LC_CLASS_CHANGED(lc,cd,dr) lc_tree_add((lc),(cd),(dr))
+#else
+#define LC_CLASS_CHANGED(lc,cd,dr)
+#endif
+
+#if (LC_SELECTION==LC_SELECT_TREE)
+
+/* add dr to the reactivity of led in the Fenwick tree over the leds */
+
+static void lc_event_tree_add(lc_global *lc, lc_event *led, lc_reactivity_t dr){
+    size_t i;
+    for ( i = led - lc->events + 1; i <= lc->max_events; i += i & -i )
+        lc->event_tree[i] += dr;
+}
+
+/* rebuild the tree from the leds, e.g. after lc_reorg has grown the array */
+
+static void lc_event_tree_build(lc_global *lc){
+    size_t i, j;
+
+    lc->event_tree = realloc(lc->event_tree, (lc->max_events+1)*sizeof(lc_reactivity_t));
+    if ( !lc->event_tree ) {
+        fprintf(stderr, "Reorganization error: run out of memory while building the event tree.\n");
+        fflush(NULL);
+        exit(1);
+    }
+    memset(lc->event_tree, 0, (lc->max_events+1)*sizeof(lc_reactivity_t));
+    for ( i = 0; i < LC_CLASS_SIZE(lc->cbeg); i++ )
+        lc->event_tree[i+1] = LC_CLASS_LED(lc->cbeg, i)->r;
+    for ( i = 1; i <= lc->max_events; i++ )
+        if ( ( j = i + ( i & -i ) ) <= lc->max_events )
+            lc->event_tree[j] += lc->event_tree[i];
+    for ( lc->event_tree_step = 1; 2*lc->event_tree_step <= lc->max_events; )
+        lc->event_tree_step *= 2;
+}
+
+/* find the led where the partial sum of reactivities exceeds r */
+
+static lc_event *lc_event_find(lc_global *lc, lc_reactivity_t r){
+    size_t pos = 0, step;
+
+    for ( step = lc->event_tree_step; step; step >>= 1 )
+        if ( pos + step <= lc->max_events && lc->event_tree[pos+step] <= r ) {
+            pos += step;
+            r   -= lc->event_tree[pos];
+        }
+    /* round-off errors may point beyond the last led */
+    if ( pos >= LC_CLASS_SIZE(lc->cbeg) )
+        pos = LC_CLASS_SIZE(lc->cbeg) - 1;
+    return LC_CLASS_LED(lc->cbeg, pos);
+}
+
+#define LC_EVENT_CHANGED(lc,led,dr) lc_event_tree_add((lc),(led),(dr))
+#else
+#define LC_EVENT_CHANGED(lc,led,dr)
+#endif
+
+#if (LC_SELECTION==LC_SELECT_LINEAR)
+
+/* find the led where the partial sum of reactivities exceeds r */
+
+static lc_event *lc_event_find(lc_global *lc, lc_reactivity_t r){
+    lc_event *led = lc->cbeg->bot, *last = lc->cbeg->top - 1;
+    lc_reactivity_t sum_r = led->r;
+
+    while ( sum_r <= r && led < last )
+        sum_r += (++led)->r;
+    return led;
+}
+#endif
+
+/* all events belong to class 0 of a one class window with LC_ONE_CLASS */
+#ifdef LC_ONE_CLASS
+#define LC_CLASS_INDEX(r,ci) ((ci)=0)
+#else
+#define LC_CLASS_INDEX(r,ci) LC_CLASS_OF(r,ci)
+#endif
+
+/* link led->ued and direct update of the link ued->led with LC_COMPACT_EVENTS */
+#ifdef LC_COMPACT_EVENTS
+#define LC_UED_LINK(lc,ued) ((uint32_t)(((char*)(ued)-(lc)->ued_base)/(lc)->ued_size))
+#define LC_EVENT_MOVED(lc,led) (((lc_base*)LC_UED((lc),(led)))->lc_ev=(led))
+#else
+#define LC_UED_LINK(lc,ued) (ued)
+#define LC_EVENT_MOVED(lc,led) ((lc)->event_moved(led))
+#endif
+
+#ifdef LC_CLASS_CHUNKS
+/* append a chunk of leds to class cd, only the table of chunks may move */
+static void lc_chunk_grow(lc_global *lc, lc_class *cd){
+    if ( cd->chunks == cd->table ) {
+        cd->table = cd->table ? 2*cd->table : 4;
+        cd->chunk = realloc(cd->chunk, cd->table*sizeof(lc_event*));
+    }
+    if ( !cd->chunk || !(cd->chunk[cd->chunks] = malloc(LC_CHUNK*sizeof(lc_event))) ) {
+        fprintf(stderr, "Reorganization error: run out of memory while allocating a chunk of event descriptors.\n");
+        fflush(NULL);
+        exit(1);
+    }
+    cd->chunks++;
+    lc->number_of_chunks++;
+}
+
+/* return the last chunk of class cd, if more than one chunk is spare */
+static void lc_chunk_shrink(lc_global *lc, lc_class *cd){
+    if ( ( (size_t) cd->chunks << LC_CHUNK_SHIFT ) >= cd->size + 2*LC_CHUNK ) {
+        free(cd->chunk[--cd->chunks]);
+        lc->number_of_chunks--;
+    }
+}
+#endif
+
+static double lc_seconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+#ifdef LC_STATS
+
+#define LC_STATS_ONLY(...) __VA_ARGS__
+#define LC_STATS_OF(lc,cd) ((lc)->stats+((cd)-(lc)->cbeg)+(lc)->min_class-(lc)->stats_min)
+
+/* extend the counters to cover the classes low .. high-1, keep the old ones */
+
+static void lc_stats_cover(lc_global *lc, int low, int high){
+    lc_class_stats *stats;
+    int min = low, max = high;
+
+    if ( lc->stats_num ) {
+        if ( lc->stats_min <= low && high <= lc->stats_min + lc->stats_num )
+            return;
+        if ( lc->stats_min < min )
+            min = lc->stats_min;
+        if ( lc->stats_min + lc->stats_num > max )
+            max = lc->stats_min + lc->stats_num;
+    }
+    stats = calloc(max-min, sizeof(lc_class_stats));
+    if ( !stats ) {
+        fprintf(stderr, "lc_stats: run out of memory for the class counters.\n");
+        fflush(NULL);
+        exit(1);
+    }
+    if ( lc->stats_num )
+        memcpy(stats + lc->stats_min - min, lc->stats,
+               lc->stats_num*sizeof(lc_class_stats));
+    free(lc->stats);
+    lc->stats     = stats;
+    lc->stats_min = min;
+    lc->stats_num = max - min;
+}
+
+/* count one draw from class cd of size events after tries tries */
+
+static void lc_stats_draw(lc_global *lc, lc_class *cd, size_t size,
+                          unsigned long long tries){
+    lc_class_stats *st = LC_STATS_OF(lc, cd);
+    int b = size ? (int)(sizeof(unsigned long long)*CHAR_BIT) - __builtin_clzll(size) : 0;
+
+    st->draws++;
+    st->tries += tries;
+    st->occupancy[b < LC_STATS_BUCKETS ? b : LC_STATS_BUCKETS-1]++;
+}
+
+#else
+#define LC_STATS_ONLY(...)
+#endif
 
 /* ========================================================================= */
 /*                                                                           */
@@ -143,13 +411,31 @@ void lc_init(lc_global *lc, size_t num_leds, void (*event_moved)(lc_event *),dou
    Called by: user-program
 */
 
-{ int    i, classlow, classhigh, classn;
+{ int    i, classlow, classhigh, classn, classmin;
+
+    LC_CLASS_OF(lc_reactivity_max,classhigh);
+    LC_CLASS_OF(lc_reactivity_min,classlow);
+    classlow--;  /* one spare extra */
+    classhigh++; /* classes are classlow .. classhigh-1 */
 
-    frexp(lc_reactivity_max,&classhigh);
-    frexp(lc_reactivity_min,&classlow);
-    classlow--; /* one spare extra */
+    /*
+    ** only a window of LC_CLASS_WINDOW classes is allocated, it is moved
+    ** by lc_getclass to the reactivities actually present
+    */
+#ifdef LC_ONE_CLASS
+    classn   = 1;
+    classmin = 0;
+#else
+    classn   = LC_CLASS_WINDOW;
+    classmin = -LC_CLASS_WINDOW/4;
+#endif
+    if(classn > classhigh - classlow)
+        classn = classhigh - classlow;
+    if(classmin > classhigh - classn)
+        classmin = classhigh - classn;
+    if(classmin < classlow)
+        classmin = classlow;
 
-    classn = classhigh - classlow;         /* number of classes required */
     if(classlow>classhigh) {
         fprintf(stderr,
                 "Error initialising class limits: lc_reactivity_max : "LC_FORMAT\
@@ -175,8 +461,12 @@ void lc_init(lc_global *lc, size_t num_leds, void (*event_moved)(lc_event *),dou
     lc->cend=lc->cbeg+classn; /* get pointer to upper limit */
 
 	lc->first=NULL;
+#ifdef LC_CLASS_CHUNKS
+    /* classes get their leds chunk by chunk, all are empty */
+    lc->events=NULL;
+#else
     /* allocate memory for event descriptors, no delimiter needed */
-    lc->cbeg->top=lc->cbeg->bot=calloc(num_leds,sizeof(lc_event));
+    lc->events=lc->cbeg->top=lc->cbeg->bot=calloc(num_leds,sizeof(lc_event));
 	lc->cbeg->next=lc->cbeg->prev=NULL;
 
     /* set pointers from class descriptors to event array, all classes are
@@ -191,25 +481,51 @@ void lc_init(lc_global *lc, size_t num_leds, void (*event_moved)(lc_event *),dou
     /* set up empty, limiting class at upper end of class descriptor array */
     lc->cbeg[classn].bot = lc->cbeg[classn].top = lc->cbeg->bot+num_leds;
     lc->cbeg[classn].next = 	lc->cbeg[classn].prev = NULL;
+#endif
     /*
        enter "linking" function into lc, "tell cell that event moved"
        is default
     */
+#ifdef LC_COMPACT_EVENTS
+    lc->event_moved=event_moved;  /* not used, see LC_EVENT_MOVED */
+    lc->ued_base=NULL;
+    lc->ued_size=1;
+#else
     if ( event_moved )
         lc->event_moved=event_moved;
     else
         lc->event_moved=lc_tell_cell_that_event_moved;
+#endif
 
     lc->max_events  = num_leds;   /* initialize remaining elements of lc */
-    lc->min_class   = classlow;
+    lc->min_class   = classmin;
     lc->num_classes = classn;
     lc->number_of_reorgs = 0;
     lc->number_of_checks = 0;
+    lc->reorg_time = lc->reorg_max_time = 0;
+    lc->reorg_moved = lc->number_of_chunks = 0;
     lc->r=0;
+    lc->rng=&rand55_g;
+#if (LC_SELECTION==LC_SELECT_TREE)
+    lc->event_tree=NULL;
+    lc_event_tree_build(lc);
+#endif
+#ifdef LC_STATS
+    lc->stats=NULL;
+    lc->stats_num=0;
+    lc_stats_cover(lc, classmin, classmin+classn);
+#endif
 
 #ifdef LC_ROUND_OFF_ERRORS
 
     lc->eps=ldexp(1,classlow+2);
+#endif
+#ifdef LC_CLASS_TREE
+    lc->class_tree=calloc(classn+1,sizeof(lc_reactivity_t));
+    lc->class_bits=calloc((classn+LC_BITS-1)/LC_BITS,sizeof(unsigned long));
+    for(lc->class_tree_step=1; 2*lc->class_tree_step<=(size_t)classn; lc->class_tree_step*=2)
+        ;
+    lc->occupied_classes=0;
 #endif
     /*
     ** remember timescale
@@ -229,12 +545,51 @@ void lc_clear(lc_global *lc) /* if lc not longer needed */
 */
 
 {
-    free(lc->cbeg->bot);   /* free event descriptors first, then class descs. */
+#ifdef LC_CLASS_CHUNKS
+    lc_class *cd;
+    for ( cd = lc->cbeg; cd < lc->cend; cd++ ) {
+        while ( cd->chunks )
+            free(cd->chunk[--cd->chunks]);
+        free(cd->chunk);
+    }
+#endif
+#ifdef LC_CLASS_TREE
+    free(lc->class_bits);
+    free(lc->class_tree);
+#endif
+#if (LC_SELECTION==LC_SELECT_TREE)
+    free(lc->event_tree);
+#endif
+#ifdef LC_STATS
+    free(lc->stats);
+#endif
+    free(lc->events);      /* free event descriptors first, then class descs. */
     free(lc->cbeg);        /* i.e. reverse allocation order                   */
 }
 
 /*--------------------------------------------------------------------------*/
 
+void lc_ued_array(lc_global *lc, void *base, size_t size)
+
+/* - remembers the array of ueds, leds refer to ueds by index into it
+     with LC_COMPACT_EVENTS
+
+   Called by: user-program
+*/
+
+{
+#ifdef LC_COMPACT_EVENTS
+    lc->ued_base = base;
+    lc->ued_size = size;
+#else
+    (void) lc;
+    (void) base;
+    (void) size;
+#endif
+}
+
+/*--------------------------------------------------------------------------*/
+
 lc_event  *lc_enter(lc_global *lc, void *ued, lc_reactivity_t r)
 
 /* - assigns a led to the event represented by ued and places it in a
@@ -247,6 +602,7 @@ lc_event  *lc_enter(lc_global *lc, void *ued, lc_reactivity_t r)
 
 { lc_class *events_class;
 
+    r = LC_EVENT_R(r);                          /* round to type of led    */
     events_class = lc_getclass(lc, r);          /* determine event's class */
     return lc_store(lc, events_class, ued, r);  /* get a led and return it */
 }
@@ -268,14 +624,27 @@ lc_event *lc_rand(lc_global *lc, lc_class **re_class_ptr)
     lc_class *re_class,  /* ptr to descriptor of class of event selected */
     **preds_next,  /* used in sorting linked list                  */
     *old_class;
-    size_t    class_size; /* number of events in class selected           */
+    size_t    class_size, /* number of events in class selected           */
+              ri;         /* index of event drawn                         */
     int       ci;         /* class index */
+    LC_STATS_ONLY(unsigned long long tries = 0;)
 
     /* Select a class by linear selection */
     sum_r=0;
     /* draw random selection limit, uniformly distributed in 0 <= r < lc_r */
-    r = (lc_reactivity_t)(((double)lc->r) *drand55());
+    r = lc_t_rand(lc->rng, lc->r);
+
+#ifdef LC_ONE_CLASS
+    /* no classes to choose from, the event is selected directly */
+    *re_class_ptr = lc->cbeg;
+    re = lc_event_find(lc, r);
+    LC_STATS_ONLY(lc_stats_draw(lc, lc->cbeg, LC_CLASS_SIZE(lc->cbeg), 1);)
+    return re;
+#endif
 
+#ifdef LC_CLASS_TREE
+    re_class = lc_tree_find(lc, r);
+#else
     /* search linked list of classes reactivites of classes searched from r
        until r <= 0, sort along the way */
 
@@ -298,6 +667,7 @@ lc_event *lc_rand(lc_global *lc, lc_class **re_class_ptr)
 		//				printf("%d old %x->%x->%x re %x->%x->%x\n",__LINE__,old_class->prev,old_class,old_class->next,
 		//								re_class->prev,re_class,re_class->next);
 
+            LC_STATS_ONLY(LC_STATS_OF(lc, re_class)->swaps++;)
             *preds_next   = re_class;  /* update link current's predecessor ->
             					current, preds_next points to pred.'s
             					next element or lc->first          */
@@ -332,8 +702,9 @@ lc_event *lc_rand(lc_global *lc, lc_class **re_class_ptr)
 
  	if(!re_class->next)
  		lc->r=sum_r;
+#endif
  		
-    class_size = re_class->top - re_class->bot; /* ->top is NOT a valid led */
+    class_size = LC_CLASS_SIZE(re_class); /* ->top is NOT a valid led */
     ci         = ( re_class - lc->cbeg ) + lc->min_class;
     /*             ^^^^^^^^^^^^^^^^^^^^     ^^^^^^^^^^^^^^
           pointers               integer
@@ -343,11 +714,15 @@ lc_event *lc_rand(lc_global *lc, lc_class **re_class_ptr)
        is maximum reactivity represented by re_class, i.e. 2^ci            */
     do {
         /* draw any event from re_class, uniformly distributed */
-        re = re_class->bot+lrand55(class_size);
-    } while ( ldexp(drand55(), ci) > re->r );   /* test rejection criterium */
+        ri = lrand55_r(lc->rng,class_size);
+        re = LC_CLASS_LED(re_class, ri);
+        LC_STATS_ONLY(tries++;)
+    } while ( lc_reject(lc->rng, ci, re->r) );   /* test rejection criterium */
+    LC_STATS_ONLY(lc_stats_draw(lc, re_class, class_size, tries);)
     /* using ldexp here is faster than calculating x=2^ci before entering the
-       loop and multiplying drand55()*x every time; besides, average acceptance
-       is 75% */
+       loop and multiplying drand55()*x every time, for integer reactivities
+       the top ci bits of a random number are compared; besides, average
+       acceptance is 75% */
 
     /* return */
     *re_class_ptr = re_class;   /* store pointer to re's class' descriptor */
@@ -370,19 +745,27 @@ lc_event *lc_knownchange(lc_global *lc, lc_class *events_class,
 */
 
 { lc_class *events_new_class;
+    int ci = events_class - lc->cbeg + lc->min_class; /* survives a move of the window */
 
+    r = LC_EVENT_R(r);   /* round to type of led */
     /* determine class according to NEW reactivity */
     events_new_class = lc_getclass(lc, r);
+    events_class     = lc->cbeg + ci - lc->min_class;
 
-    if ( events_new_class == events_class )  /* event remains in old class */
+    /* r==0 may map to the class of the event, e.g. with LC_ONE_CLASS, the
+       led has to go all the same */
+    if ( events_new_class == events_class && r != 0 )  /* event remains in old class */
     {                                      /* just update reactivities   */
         events_class->r += (r - led->r);     /* class reactivity           */
         lc->r          += (r - led->r);     /* total     "                */
+        LC_CLASS_CHANGED(lc, events_class, r - led->r);
+        LC_EVENT_CHANGED(lc, led, r - led->r);
         led->r           = r;                /* event's reactivity         */
 #ifdef LC_ROUND_OFF_ERRORS
         /* check for accumulated round-off errors and set to 0 */
         if ( events_class->r < lc->eps ) {
             lc->r -= events_class->r;
+            LC_CLASS_CHANGED(lc, events_class, -events_class->r);
             events_class->r = 0;
         }
         if ( lc->r < lc->eps )
@@ -425,7 +808,9 @@ lc_event *lc_safechange(lc_global *lc, lc_event *led, void *ued, lc_reactivity_t
             return NULL;
         } else
             return lc_knownchange(lc, lc_getclass(lc, led->r), led, ued ,r);
-    } else            /* the event has to be assigned a led */
+    } else if ( r == 0 )   /* nothing to enter */
+        return NULL;
+    else            /* the event has to be assigned a led */
         return lc_enter(lc, ued, r);
 }
 
@@ -445,21 +830,39 @@ void lc_delete(lc_global *lc, lc_class *events_class, lc_event *led)
    Calls    : lc->event_moved
 */
 
-{ lc_reactivity_t ci;      /* class index */
+{ lc_event *top;           /* led at the top of the class */
 
     if ( !events_class || !led )   /* just to be on the safe side */
         return;
 
     events_class->r -= led->r;  /* reduce class and */
     lc->r          -= led->r;  /* total reactivity */
+    LC_CLASS_CHANGED(lc, events_class, -led->r);
+    LC_EVENT_CHANGED(lc, led, -led->r);
 
     /* remove led from class' array of leds F[] */
-    events_class->top--; /* ->top, i.e. the delimiting, invalid led just beyond
+#ifdef LC_CLASS_CHUNKS
+    events_class->size--;
+    top = LC_CLASS_LED(events_class, events_class->size);
+#else
+    top = --events_class->top; /* ->top, i.e. the delimiting, invalid led just beyond
     			  the last valid led in the array, goes down by one
     			  as array is kept contiguous */
+#endif
 
    LC_CHECK_QUEUE(lc,"before delete");
-   	if ( events_class->top == events_class->bot ) {
+#ifdef LC_CLASS_TREE
+    if ( !LC_CLASS_SIZE(events_class) ) {
+        /* an empty class holds nothing but round-off errors */
+        lc->r -= events_class->r;
+        LC_CLASS_CHANGED(lc, events_class, -events_class->r);
+        events_class->r = 0;
+        lc_bits_clear(lc, events_class);
+        if ( !lc->occupied_classes )
+            lc->r = 0;
+    }
+#else
+   	if ( !LC_CLASS_SIZE(events_class) ) {
    		//events_class->r = 0;
    		if(events_class==lc->first){
    			lc->first=lc->first->next;
@@ -478,19 +881,26 @@ void lc_delete(lc_global *lc, lc_class *events_class, lc_event *led)
 	 		
 	   	}
     }
+#endif
  	LC_CHECK_QUEUE(lc,"after delete");
     
-    if ( led != events_class->top )   /* if led is not at the top of the array,
+    if ( led != top )   /* if led is not at the top of the array,
         				       we got a gap inside */
     {
-        *led = *(events_class->top);  /* fill the gap by the led at top */
-        lc->event_moved(led); /* update the link ued->led for the event moved */
+        LC_EVENT_CHANGED(lc, top, -top->r);
+        *led = *top;  /* fill the gap by the led at top */
+        LC_EVENT_CHANGED(lc, led, led->r);
+        LC_EVENT_MOVED(lc, led); /* update the link ued->led for the event moved */
     }
+#ifdef LC_CLASS_CHUNKS
+    lc_chunk_shrink(lc, events_class);
+#endif
 
 }  /* end -- lc_delete */
 
 /*--------------------------------------------------------------------------*/
 
+#ifndef LC_COMPACT_EVENTS
 void lc_tell_cell_that_event_moved(lc_event *lce) {
     ((lc_base*)(lce->ued))->lc_ev=lce;
     /*
@@ -498,22 +908,143 @@ void lc_tell_cell_that_event_moved(lc_event *lce) {
        the cell is noticed this way
     */
 }
+#endif
+
+
+
+/*--------------------------------------------------------------------------*/
+
+static void lc_window(lc_global *lc, int ci)
 
+/* - moves the window of class descriptors, so it comprises class ci,
+     i.e. reactivities 2^(ci-1) <= r < 2^ci
+   - grows by LC_CLASS_WINDOW/4 spare classes beyond ci and drops empty
+     classes at the other end, so the window slides along with drifting
+     reactivities
+   - class descriptors are moved, leds are not; new classes are empty
+     and get their leds at the next lc_reorg
 
+   Called by: lc_getclass
+*/
+
+{ int       low, high, classlow, classhigh, margin, i;
+  lc_class *cbeg, *cd;
+#ifndef LC_CLASS_CHUNKS
+  lc_event *end = lc->cend->bot;
+#endif
+
+    LC_CLASS_OF(lc_reactivity_max,classhigh);
+    LC_CLASS_OF(lc_reactivity_min,classlow);
+    classlow--;
+    classhigh++;
+    if ( ci < classlow || ci >= classhigh ) {
+        fprintf(stderr, "Reactivity out of range of classes: class %d, range %d .. %d\n",
+                ci, classlow, classhigh-1);
+        fflush(NULL);
+        exit(1);
+    }
+
+    margin = LC_CLASS_WINDOW/4 ? LC_CLASS_WINDOW/4 : 1;
+    low    = lc->min_class;
+    high   = lc->min_class + lc->num_classes;   /* window is low .. high-1 */
+
+#define LC_EMPTY(c) (!LC_CLASS_SIZE(lc->cbeg+(c)-lc->min_class))
+    if ( ci < low ) {
+        low = ci - margin;
+        while ( high - low > LC_CLASS_WINDOW && high > lc->min_class && LC_EMPTY(high-1) )
+            high--;
+    } else {
+        high = ci + 1 + margin;
+        while ( high - low > LC_CLASS_WINDOW && low < lc->min_class + lc->num_classes && LC_EMPTY(low) )
+            low++;
+    }
+#undef LC_EMPTY
+    if ( low < classlow )
+        low = classlow;
+    if ( high > classhigh )
+        high = classhigh;
+
+    /* copy the descriptors into the new window, one extra as upper limit */
+    cbeg = calloc(high-low+1, sizeof(lc_class));
+    if ( !cbeg ) {
+        fprintf(stderr, "Reorganization error: run out of memory while moving class descriptors.\n");
+        fflush(NULL);
+        exit(1);
+    }
+    for ( i = low; i < high; i++ ) {
+        cd = cbeg + i - low;
+        if ( i < lc->min_class || i >= lc->min_class + lc->num_classes ) {
+#ifndef LC_CLASS_CHUNKS
+            if ( i < lc->min_class )          /* new classes at the bottom */
+                cd->bot = cd->top = ( i == low ) ? lc->events : lc->cbeg->bot;
+            else                              /* ... at the top */
+                cd->bot = cd->top = end;
+#endif
+        } else {
+            *cd = lc->cbeg[i - lc->min_class];
+            if ( cd->next )
+                cd->next = cbeg + ( cd->next - lc->cbeg ) + lc->min_class - low;
+            if ( cd->prev )
+                cd->prev = cbeg + ( cd->prev - lc->cbeg ) + lc->min_class - low;
+        }
+    }
+#ifndef LC_CLASS_CHUNKS
+    cbeg[high-low].bot = cbeg[high-low].top = end;
+#endif
+    if ( lc->first )
+        lc->first = cbeg + ( lc->first - lc->cbeg ) + lc->min_class - low;
+
+#ifdef LC_CLASS_CHUNKS
+    /* the classes dropped are empty, return their chunks */
+    for ( cd = lc->cbeg, i = lc->min_class; cd < lc->cend; cd++, i++ ) {
+        if ( i >= low && i < high )
+            continue;
+        lc->number_of_chunks -= cd->chunks;
+        while ( cd->chunks )
+            free(cd->chunk[--cd->chunks]);
+        free(cd->chunk);
+    }
+#endif
+    free(lc->cbeg);
+    lc->cbeg        = cbeg;
+    lc->cend        = cbeg + high - low;
+    lc->min_class   = low;
+    lc->num_classes = high - low;
+    LC_STATS_ONLY(lc_stats_cover(lc, low, high);)
+
+#ifdef LC_CLASS_TREE
+    free(lc->class_tree);
+    free(lc->class_bits);
+    lc->class_tree = calloc(lc->num_classes+1, sizeof(lc_reactivity_t));
+    lc->class_bits = calloc((lc->num_classes+LC_BITS-1)/LC_BITS, sizeof(unsigned long));
+    for ( lc->class_tree_step = 1; 2*lc->class_tree_step <= (size_t) lc->num_classes; )
+        lc->class_tree_step *= 2;
+    lc->occupied_classes = 0;
+    for ( cd = lc->cbeg; cd < lc->cend; cd++ )
+        if ( LC_CLASS_SIZE(cd) )
+            lc_bits_set(lc, cd);
+    lc_tree_build(lc);
+#endif
+} /* end -- lc_window */
 
 /*--------------------------------------------------------------------------*/
 
 lc_class *lc_getclass(lc_global *lc, lc_reactivity_t r)
 
 /* - determines the class that comprises the reactivity r
+   - moves the window of classes if r is outside
 
    Called by: lc_enter, lc_knownchange, lc_unknownchange
 */
 { int    ci;    /* class index */
 
     /* calculate class index */
+#if defined(LC_ROUND_OFF_ERRORS) && !defined(LC_FAST_EXPONENT)
     errno = 0;       /* reset before use                               */
-    frexp(r,&ci);    /* class index is defined by 2^(ci-1) <= r < 2^ci */
+#endif
+    LC_CLASS_INDEX(r,ci);  /* class index is defined by 2^(ci-1) <= r < 2^ci */
+    if ( ci < lc->min_class || ci >= lc->min_class + lc->num_classes )
+        lc_window(lc, ci);
     ci -= lc->min_class;  /* subtract offset to get class-array index */
 
     /* if ok, return pointer to class descriptor */
@@ -523,7 +1054,14 @@ lc_class *lc_getclass(lc_global *lc, lc_reactivity_t r)
 
 /*--------------------------------------------------------------------------*/
 
+static void lc_reorg_reserve(lc_global *lc, size_t reserve);
+
 void lc_reorg(lc_global *lc)
+{
+    lc_reorg_reserve(lc, 0);
+}
+
+static void lc_reorg_reserve(lc_global *lc, size_t reserve)
 
 /* This function is called if all leds allocated for a class have been
    assigned to events and lc_store requests another led in that class.
@@ -533,7 +1071,8 @@ void lc_reorg(lc_global *lc)
    just the "free" leds have been shifted around.  All links are main-
    tained properly.
    To do so, lc_rand employs the following strategy:
-     0. Recalculate class and total reactivites to reduce round-off errors.
+     0. Recalculate class and total reactivites to reduce round-off errors
+        (not with integer reactivities).
      1. Move all assigned leds downward in memory, so they occupy a
         contiguous are in memory between lc->cbeg->bot and
 	lc->cbeg[lc->num_classes-1]->top and all "free" leds occupy
@@ -542,7 +1081,13 @@ void lc_reorg(lc_global *lc)
         with the highest class.
      3. Update the links ued->led for all events using lc->event_moved.
 
-   Called by: lc_store
+   With LC_CLASS_CHUNKS only step 0 is done, lc_store does not call
+   lc_reorg then, but the user program may to reduce round-off errors.
+
+   Every class gets at least 2+reserve free leds, lc_update_batch
+   reserves room for all events of a batch this way.
+
+   Called by: lc_store, lc_update_batch
    Calls    : lc->event_moved
 */
 
@@ -552,24 +1097,29 @@ void lc_reorg(lc_global *lc)
     tot_needed,   /* total number of leds needed          */
     prop_needed;  /* proposede number of needed leds      */
 
-    lc_event *led;
+    lc_event *led, *moved;
     lc_class *cd;
     int       ci;           /* class index                   */
-    size_t    shift=0;
+    int       all=0;        /* all classes have moved        */
+    size_t   *off;          /* bot and top of the classes as
+                               indices while reallocating    */
+    double    start=lc_seconds();
 
-    /* 0. recalculate reactivities */
+#ifdef LC_ROUND_OFF_ERRORS
+    /* 0. recalculate reactivities, integer sums are exact anyway */
     for ( cd = lc->cbeg, lc->r = 0; cd < lc->cend; cd++ ) {
-        for ( led = cd->bot, cd->r = 0; led < cd->top; led++ )
-            cd->r += led->r;
+        for ( class_size = 0, cd->r = 0; class_size < LC_CLASS_SIZE(cd); class_size++ )
+            cd->r += LC_CLASS_LED(cd, class_size)->r;
         lc->r += cd->r;
     }
+#endif
 
-    for(tot_needed = 2*lc->num_classes , ci=0; ci< lc->num_classes; ci++)
+#ifndef LC_CLASS_CHUNKS   /* chunks of leds never need to be moved */
+
+    for(tot_needed = (2+reserve)*lc->num_classes , ci=0; ci< lc->num_classes; ci++)
         tot_needed += lc->cbeg[ci].top - lc->cbeg[ci].bot;
     debug_printf("tot %d\n",tot_needed);
 
-    led=lc->cbeg->bot;
-
     prop_needed=tot_needed;
     /*
     **  0. Compute sizes and shifts
@@ -584,38 +1134,41 @@ void lc_reorg(lc_global *lc)
             prop_needed*=2;
 
         /*
-        ** recycle and allocate new memory
+        ** keep the classes as indices, realloc may move the block to an
+        ** address that is not a whole number of leds away
         */
-        lc->cbeg->bot=realloc(led,prop_needed*sizeof(lc_event));
-        /*
-        ** for testing purpose
-        */
-        /* 		lc->cbeg->bot=calloc(prop_needed,sizeof(lc_event)); */
-        /* 		memmove(lc->cbeg->bot,led,lc->max_events*sizeof(lc_event)); */
-        /* 		free(led); */
-        debug_printf("needed %d expanding from %d to %d\n",tot_needed,lc->max_events,prop_needed);
+        off=malloc(2*(lc->num_classes+1)*sizeof(size_t));
+        if(off)
+            for ( ci = 0; ci <= lc->num_classes; ci++ ) {
+                off[2*ci]   = lc->cbeg[ci].bot - lc->events;
+                off[2*ci+1] = lc->cbeg[ci].top - lc->events;
+            }
 
         /*
-        ** how much do we have to shift the top and bot(tom) pointers of each class?
-        */
-        shift=lc->cbeg->bot -led;
-        /*
-        ** Lowest class here
+        ** recycle and allocate new memory
         */
-        lc->cbeg->top+=shift;
+        led = off ? realloc(lc->events,prop_needed*sizeof(lc_event)) : NULL;
+        debug_printf("needed %d expanding from %d to %d\n",tot_needed,lc->max_events,prop_needed);
 
-        if(! lc->cbeg->bot) {
+        if(! led) {
             fprintf(stderr, "Reorganization error: run out of memory while reorganizing event descriptors.\n");
             fflush(NULL);
             exit(1);
         }
+        lc->events=led;
+
         /*
-        ** Move the class end cend to stretch the classes below
-        ** cend is empty and not crunched and stretched below
+        ** rebuild the pointers from the new base, move the class end cend
+        ** to stretch the classes below, cend is empty and not crunched and
+        ** stretched below
         */
-
-				lc->cend->bot+=shift+(prop_needed-lc->max_events);
-        lc->cend->top+=shift+(prop_needed-lc->max_events);
+        for ( ci = 0; ci <= lc->num_classes; ci++ ) {
+            size_t grow = ci == lc->num_classes ? prop_needed-lc->max_events : 0;
+            lc->cbeg[ci].bot = lc->events + off[2*ci] + grow;
+            lc->cbeg[ci].top = lc->events + off[2*ci+1] + grow;
+        }
+        free(off);
+        all=1;
 
         /*
         ** max_events becomes the proposed needed value
@@ -628,31 +1181,31 @@ void lc_reorg(lc_global *lc)
                  ci,new_size,class_size,lc->cbeg[ci].r,lc->cbeg[ci].bot,lc->cbeg[ci].top,lc->cbeg[ci].bot-lc->cbeg[0].bot);
     /* 1. move assigned leds downward, calculate no. of leds needed */
     /*   add a little extra and reserve 2 leds for classes currently empty */
-    /* needed for lowest class */
-    for ( ci = 1; ci < lc->num_classes; ci++) {
-        /*
-        ** shift the top and bot pointers
-        */
-        lc->cbeg[ci].bot+=shift;
-        lc->cbeg[ci].top+=shift;
-
+    /*   the lowest class moves to the bottom of the array, if the window  */
+    /*   of classes has been moved up                                      */
+    for ( ci = 0; ci < lc->num_classes; ci++) {
         class_size = lc->cbeg[ci].top - lc->cbeg[ci].bot;
+        moved = ci ? lc->cbeg[ci-1].top : lc->events;
+        if ( moved == lc->cbeg[ci].bot )
+            continue;
+        if ( !ci )
+            all = 1;      /* the lowest class needs an update of links, too */
         /* move assigned leds of class ci down using memove(to, from, bytes) */
-        memmove(lc->cbeg[ci-1].top, lc->cbeg[ci].bot,
+        memmove(moved, lc->cbeg[ci].bot,
                 class_size * sizeof(lc_event));
         /* update pointers from class descriptors to class' array of leds
            making use of the contiguous packing of assigned leds          */
-        lc->cbeg[ci].bot = lc->cbeg[ci-1].top;
+        lc->cbeg[ci].bot = moved;
         lc->cbeg[ci].top = lc->cbeg[ci].bot + class_size;
-        debug_printf("%2d: sh=%2d s=%2d r=%5d b=%X t=%X x=%4d\n",
-                     ci,shift,class_size,lc->cbeg[ci].r,lc->cbeg[ci].bot,lc->cbeg[ci].top,lc->cbeg[ci].bot-lc->cbeg[0].bot);
+        debug_printf("%2d: a=%2d s=%2d r=%5d b=%X t=%X x=%4d\n",
+                     ci,all,class_size,lc->cbeg[ci].r,lc->cbeg[ci].bot,lc->cbeg[ci].top,lc->cbeg[ci].bot-lc->cbeg[0].bot);
     }  /* end -- for ( ci = 1; ... */
 
 
     /* 2. move leds up to the new locations class by class, starting from top */
     for ( ci = lc->num_classes - 1; ci ; ci--)   {
         class_size = lc->cbeg[ci].top - lc->cbeg[ci].bot;
-        new_size   = (size_t) floor((class_size+2.0) *
+        new_size   = (size_t) floor((class_size+2.0+reserve) *
                                     (lc->max_events / (lc_reactivity_t) prop_needed));
 
         /* bottom of class ci's led-array is reached from bottom of class ci+1
@@ -681,14 +1234,27 @@ void lc_reorg(lc_global *lc)
 
     /*
     ** 3. update links ued->led
-    ** If no realloc was called, the lowest class needs not to be moved.
-    ** Than we start at ci=1
+    ** If no realloc was called and the lowest class was at the bottom
+    ** already, it has not been moved. Than we start at ci=1
     */
-    for ( ci = (led ==lc->cbeg->bot) ; ci < lc->num_classes; ci++ )
-        for ( led = lc->cbeg[ci].bot;  led < lc->cbeg[ci].top; led++ )
-            lc->event_moved(led);
+    for ( ci = !all ; ci < lc->num_classes; ci++ )
+        for ( led = lc->cbeg[ci].bot;  led < lc->cbeg[ci].top; led++ ) {
+            LC_EVENT_MOVED(lc, led);
+            lc->reorg_moved++;
+        }
+#endif
 
+#ifdef LC_CLASS_TREE
+    lc_tree_build(lc);       /* class reactivities have been recalculated */
+#endif
+#if (LC_SELECTION==LC_SELECT_TREE)
+    lc_event_tree_build(lc); /* leds may have moved, the array may have grown */
+#endif
     lc->number_of_reorgs++;  /* maintain counter for performance control */
+    start = lc_seconds() - start;
+    lc->reorg_time += start;
+    if ( start > lc->reorg_max_time )
+        lc->reorg_max_time = start;
     return;
 }  /* end -- lc_reorg */
 
@@ -713,8 +1279,13 @@ lc_event  *lc_store(lc_global *lc, lc_class *events_class, void *ued,
 	lc_class * class_i, *old_class_i;
    
    	LC_CHECK_QUEUE(lc,"before insert");
+    r = LC_EVENT_R(r);   /* round to type of led, a no-op if called by lc_enter */
     	/* empty class */
-	if(events_class->bot==events_class->top){
+#ifdef LC_CLASS_TREE
+	if(!LC_CLASS_SIZE(events_class))
+		lc_bits_set(lc,events_class);
+#else
+	if(!LC_CLASS_SIZE(events_class)){
 		
 		if(lc->first){
 			old_class_i=class_i= lc->first ;
@@ -750,7 +1321,15 @@ lc_event  *lc_store(lc_global *lc, lc_class *events_class, void *ued,
 			LC_CHECK_QUEUE(lc,"first");
 		}
 	}
+#endif
 	LC_CHECK_QUEUE(lc,"after insert");
+#ifdef LC_CLASS_CHUNKS
+    /* a full class gets another chunk, no other class is touched */
+    if ( events_class->size == ( (size_t) events_class->chunks << LC_CHUNK_SHIFT ) )
+        lc_chunk_grow(lc, events_class);
+    led = LC_CLASS_LED(events_class, events_class->size);
+    events_class->size++;
+#else
     led = events_class->top;   /* top is the first "free" led */
 
     /* check for collision with next class */
@@ -761,10 +1340,13 @@ lc_event  *lc_store(lc_global *lc, lc_class *events_class, void *ued,
     }
 
     events_class->top++;   /* move top                   */
-    led->ued = ued;        /* create link to ued         */
+#endif
+    led->ued = LC_UED_LINK(lc, ued);  /* create link to ued */
     led->r   = r;          /* store event's reactivity   */
     events_class->r += r;  /* update classes' reactivity */
     lc->r          += r;  /* update total reactivity    */
+    LC_CLASS_CHANGED(lc, events_class, r);
+    LC_EVENT_CHANGED(lc, led, r);
 	LC_CHECK_QUEUE(lc,"lc_store end");
 	return led;     /* ... pointer to assigned led */
 
@@ -786,6 +1368,433 @@ lc_event *lc_unknownchange(lc_global *lc, lc_event *led, void *ued,
     return lc_knownchange(lc, lc_getclass(lc, led->r), led, ued, r);
 }
 
+/*--------------------------------------------------------------------------*/
+
+static lc_event lc_batch_none;   /* marks ueds of the batch done with r==0 */
+
+void lc_update_batch(lc_global *lc, void **ueds, const lc_reactivity_t *r,
+                     size_t n)
+
+/* - update the reactivities of n events at once, see logclass.h
+
+   Called by: user-program
+   Calls    : lc_getclass, lc_delete, lc_store
+*/
+
+{ lc_reactivity_t dr = 0, ri;
+  lc_class *events_class, *events_new_class;
+  lc_event *led;
+  size_t    i;
+  int       ci, new_ci;
+#ifndef LC_CLASS_CHUNKS
+  size_t    most = 0;
+  int       lo = INT_MAX, hi = -1, k;
+  int       full = 0;
+#endif
+
+    /* 1. events remaining in their class, collect the change of lc->r */
+    for ( i = 0; i < n; i++ ) {
+        if ( !(led = ((lc_base*)ueds[i])->lc_ev) )
+            continue;
+        ri = LC_EVENT_R(r[i]);
+        LC_CLASS_INDEX(ri, new_ci);
+        LC_CLASS_INDEX((lc_reactivity_t)led->r, ci);
+        if ( ri == 0 || ci != new_ci )
+            continue;                 /* moved in step 2 and 3 */
+        events_class = lc_getclass(lc, ri);
+        events_class->r += (ri - led->r);
+        dr              += (ri - led->r);
+        LC_CLASS_CHANGED(lc, events_class, ri - led->r);
+        LC_EVENT_CHANGED(lc, led, ri - led->r);
+        led->r           = ri;
+#ifdef LC_ROUND_OFF_ERRORS
+        if ( events_class->r < lc->eps ) {
+            dr -= events_class->r;
+            LC_CLASS_CHANGED(lc, events_class, -events_class->r);
+            events_class->r = 0;
+        }
+#endif
+    }
+    lc->r += dr;
+#ifdef LC_ROUND_OFF_ERRORS
+    if ( lc->r < lc->eps )
+        lc->r = 0;
+#endif
+
+    /* 2. delete the events leaving their class */
+    for ( i = 0; i < n; i++ ) {
+        if ( !(led = ((lc_base*)ueds[i])->lc_ev) )
+            continue;
+        ri = LC_EVENT_R(r[i]);
+        LC_CLASS_INDEX(ri, new_ci);
+        LC_CLASS_INDEX((lc_reactivity_t)led->r, ci);
+        if ( ri != 0 && ci == new_ci )
+            continue;
+        events_class = lc_getclass(lc, led->r);
+        lc_delete(lc, events_class, led);
+        ((lc_base*)ueds[i])->lc_ev = NULL;
+    }
+
+#ifndef LC_CLASS_CHUNKS
+    /* 3a. room for all of them, by one reorganisation before the first
+           store; the window of classes is moved first */
+    for ( i = 0; i < n; i++ )
+        if ( !((lc_base*)ueds[i])->lc_ev && (ri = LC_EVENT_R(r[i])) != 0 )
+            lc_getclass(lc, ri);
+    for ( i = 0; i < n; i++ )
+        if ( !((lc_base*)ueds[i])->lc_ev && (ri = LC_EVENT_R(r[i])) != 0 ) {
+            k = (int)(lc_getclass(lc, ri) - lc->cbeg);
+            if ( k < lo ) lo = k;
+            if ( k > hi ) hi = k;
+        }
+    if ( lo <= hi ) {
+        /* events per class of the range, counted in one pass */
+        size_t need[hi - lo + 1];
+
+        memset(need, 0, sizeof(need));
+        for ( i = 0; i < n; i++ )
+            if ( !((lc_base*)ueds[i])->lc_ev && (ri = LC_EVENT_R(r[i])) != 0 )
+                need[lc_getclass(lc, ri) - lc->cbeg - lo]++;
+        for ( k = lo; k <= hi; k++ ) {
+            events_new_class = lc->cbeg + k;
+            if ( need[k - lo] > most )
+                most = need[k - lo];
+            if ( (size_t)((events_new_class+1)->bot - events_new_class->top) < need[k - lo] )
+                full = 1;
+        }
+    }
+    if ( full )
+        lc_reorg_reserve(lc, most);
+#endif
+
+    /* 3. store them into their new classes, backwards, so the last
+          reactivity given for an ued counts; lc_store finds room */
+    for ( i = n; i-- > 0; ) {
+        if ( ((lc_base*)ueds[i])->lc_ev )
+            continue;
+        ri = LC_EVENT_R(r[i]);
+        if ( ri == 0 ) {
+            ((lc_base*)ueds[i])->lc_ev = &lc_batch_none;
+            continue;
+        }
+        events_new_class = lc_getclass(lc, ri);
+        ((lc_base*)ueds[i])->lc_ev = lc_store(lc, events_new_class, ueds[i], ri);
+    }
+    for ( i = 0; i < n; i++ )
+        if ( ((lc_base*)ueds[i])->lc_ev == &lc_batch_none )
+            ((lc_base*)ueds[i])->lc_ev = NULL;
+    LC_CHECK_QUEUE(lc,"lc_update_batch");
+
+}  /* end -- lc_update_batch */
+
+/*--------------------------------------------------------------------------*/
+
+size_t lc_stats(const lc_global *lc, int *min_class,
+                const lc_class_stats **stats)
+
+/* - hand out the counters kept with LC_STATS, see logclass.h
+
+   Called by: user-program
+*/
+
+{
+#ifdef LC_STATS
+    *min_class = lc->stats_min;
+    *stats     = lc->stats;
+    return lc->stats_num;
+#else
+    (void) lc;
+    *min_class = 0;
+    *stats     = NULL;
+    return 0;
+#endif
+}
+
+/*--------------------------------------------------------------------------*/
+
+int lc_stats_dump(const lc_global *lc, const char *filename)
+
+/* - write the counters as text, see logclass.h
+
+   Called by: user-program
+*/
+
+{ FILE *f = strcmp(filename, "-") ? fopen(filename, "w") : stdout;
+  int   err;
+#ifdef LC_STATS
+  const lc_class_stats *st;
+  int   ci, b;
+#endif
+
+    if ( !f )
+        return -1;
+    fprintf(f, "# reorgs %lu time %g max_time %g moved %lu chunks %lu\n",
+            (unsigned long) lc->number_of_reorgs, lc->reorg_time,
+            lc->reorg_max_time, (unsigned long) lc->reorg_moved,
+            (unsigned long) lc->number_of_chunks);
+#ifdef LC_STATS
+    fprintf(f, "# class: 2^(class-1) <= r < 2^class, acceptance = draws/tries,\n"
+               "# occupancy[b]: draws with 2^(b-1) <= class size < 2^b\n"
+               "# class draws tries acceptance swaps occupancy[0..%d]\n",
+            LC_STATS_BUCKETS-1);
+    for ( ci = 0; ci < lc->stats_num; ci++ ) {
+        st = lc->stats + ci;
+        if ( !st->draws && !st->swaps )
+            continue;
+        fprintf(f, "%d %llu %llu %g %llu", ci + lc->stats_min, st->draws,
+                st->tries, st->tries ? (double) st->draws / st->tries : 0.0,
+                st->swaps);
+        for ( b = 0; b < LC_STATS_BUCKETS; b++ )
+            fprintf(f, " %llu", st->occupancy[b]);
+        fprintf(f, "\n");
+    }
+#endif
+    err = ferror(f);
+    if ( f == stdout )
+        err |= fflush(f);
+    else
+        err |= fclose(f);
+    return err ? -1 : 0;
+}
+
+/*--------------------------------------------------------------------------*/
+
+/* the scalars of lc_global and a class as lc_save writes them, pointers
+   become indices, LC_SAVED_NONE stands for NULL                         */
+#define LC_SAVED_NONE ((size_t) -1)
+#define LC_SAVED_BLOCK 4096
+#define LC_MAX(a,b) ((a) > (b) ? (a) : (b))
+#define LC_MIN(a,b) ((a) < (b) ? (a) : (b))
+
+typedef struct LC_SAVED {
+    int        min_class, num_classes;
+    size_t     max_events, first;
+    lc_reactivity_t r, eps;
+    double     time_scale;
+    lc_reorg_t number_of_reorgs;
+    size_t     number_of_checks;
+    double     reorg_time, reorg_max_time;
+    size_t     reorg_moved, number_of_chunks;
+    int        stats_min, stats_num, occupied_classes;
+} lc_saved;
+
+typedef struct LC_SAVED_CLASS {
+    size_t          bot, top, next, prev;
+    lc_reactivity_t r;
+} lc_saved_class;
+
+int lc_save(const lc_global *lc, FILE *f, const void *ued_base, size_t ued_size)
+
+/* - write lc to f, see logclass.h
+
+   Called by: user-program
+*/
+
+{
+#ifdef LC_CLASS_CHUNKS
+    fprintf(stderr, "lc_save: the chunks of LC_CLASS_CHUNKS are not saved\n");
+    return -1;
+#else
+    lc_saved       s;
+    lc_saved_class sc;
+    lc_event       buf[LC_SAVED_BLOCK];
+    const lc_class *cd;
+    size_t         b, n, i;
+
+    memset(&s, 0, sizeof(s));
+    s.min_class        = lc->min_class;
+    s.num_classes      = lc->num_classes;
+    s.max_events       = lc->max_events;
+    s.first            = lc->first ? (size_t)( lc->first - lc->cbeg ) : LC_SAVED_NONE;
+    s.r                = lc->r;
+#ifdef LC_ROUND_OFF_ERRORS
+    s.eps              = lc->eps;
+#endif
+    s.time_scale       = lc->time_scale;
+    s.number_of_reorgs = lc->number_of_reorgs;
+    s.number_of_checks = lc->number_of_checks;
+    s.reorg_time       = lc->reorg_time;
+    s.reorg_max_time   = lc->reorg_max_time;
+    s.reorg_moved      = lc->reorg_moved;
+    s.number_of_chunks = lc->number_of_chunks;
+#ifdef LC_STATS
+    s.stats_min        = lc->stats_min;
+    s.stats_num        = lc->stats_num;
+#endif
+#ifdef LC_CLASS_TREE
+    s.occupied_classes = lc->occupied_classes;
+#endif
+    fwrite(&s, sizeof(s), 1, f);
+
+    /* the limiting class at cend too */
+    for ( cd = lc->cbeg; cd <= lc->cend; cd++ ) {
+        memset(&sc, 0, sizeof(sc));
+        sc.bot  = cd->bot - lc->events;
+        sc.top  = cd->top - lc->events;
+        sc.next = cd->next ? (size_t)( cd->next - lc->cbeg ) : LC_SAVED_NONE;
+        sc.prev = cd->prev ? (size_t)( cd->prev - lc->cbeg ) : LC_SAVED_NONE;
+        sc.r    = cd->r;
+        fwrite(&sc, sizeof(sc), 1, f);
+    }
+
+    /* leds block by block, only those in a class refer to a ued */
+    for ( b = 0; b < lc->max_events; b += n ) {
+        n = lc->max_events - b < LC_SAVED_BLOCK ? lc->max_events - b : LC_SAVED_BLOCK;
+        memset(buf, 0, n*sizeof(lc_event));
+        for ( cd = lc->cbeg; cd < lc->cend; cd++ )
+            for ( i = LC_MAX((size_t)( cd->bot - lc->events ), b);
+                  i < LC_MIN((size_t)( cd->top - lc->events ), b + n); i++ ) {
+                buf[i-b] = lc->events[i];
+#ifndef LC_COMPACT_EVENTS
+                buf[i-b].ued = (void *)( ( (const char *) lc->events[i].ued
+                                           - (const char *) ued_base ) / ued_size );
+#endif
+            }
+        fwrite(buf, sizeof(lc_event), n, f);
+    }
+
+#if (LC_SELECTION==LC_SELECT_TREE)
+    fwrite(lc->event_tree, sizeof(lc_reactivity_t), lc->max_events+1, f);
+#endif
+#ifdef LC_CLASS_TREE
+    fwrite(lc->class_tree, sizeof(lc_reactivity_t), lc->num_classes+1, f);
+    fwrite(lc->class_bits, sizeof(unsigned long), (lc->num_classes+LC_BITS-1)/LC_BITS, f);
+#endif
+#ifdef LC_STATS
+    fwrite(lc->stats, sizeof(lc_class_stats), lc->stats_num, f);
+#endif
+    return ferror(f) ? -1 : 0;
+#endif
+}  /* end -- lc_save */
+
+/*--------------------------------------------------------------------------*/
+
+/* copy n bytes of the saved data to dst, fail if they run beyond end */
+#define LC_TAKE(dst, n) \
+    do { if ( (size_t)( end - p ) < (size_t)(n) ) goto fail; \
+         memcpy((dst), p, (n)); p += (n); } while ( 0 )
+
+const char *lc_load(lc_global *lc, const char *p, const char *end,
+                    void *ued_base, size_t ued_size)
+
+/* - set up lc from the data lc_save has written, see logclass.h
+
+   Called by: user-program
+*/
+
+{
+#ifdef LC_CLASS_CHUNKS
+    return NULL;
+#else
+    lc_global      l;
+    lc_saved       s;
+    lc_saved_class sc;
+    lc_class      *cd;
+    lc_event      *led;
+    size_t         ci;
+
+    memset(&l, 0, sizeof(l));
+    LC_TAKE(&s, sizeof(s));
+    if ( s.num_classes < 1 || s.max_events < 1
+         || ( s.first != LC_SAVED_NONE && s.first >= (size_t) s.num_classes ) )
+        goto fail;
+
+    l.cbeg   = calloc(s.num_classes+1, sizeof(lc_class));
+    l.events = malloc(s.max_events*sizeof(lc_event));
+    if ( !l.cbeg || !l.events )
+        goto fail;
+    l.cend   = l.cbeg + s.num_classes;
+    for ( ci = 0; ci <= (size_t) s.num_classes; ci++ ) {
+        LC_TAKE(&sc, sizeof(sc));
+        if ( sc.bot > sc.top || sc.top > s.max_events
+             || ( sc.next != LC_SAVED_NONE && sc.next >= (size_t) s.num_classes )
+             || ( sc.prev != LC_SAVED_NONE && sc.prev >= (size_t) s.num_classes ) )
+            goto fail;
+        cd       = l.cbeg + ci;
+        cd->bot  = l.events + sc.bot;
+        cd->top  = l.events + sc.top;
+        cd->next = sc.next == LC_SAVED_NONE ? NULL : l.cbeg + sc.next;
+        cd->prev = sc.prev == LC_SAVED_NONE ? NULL : l.cbeg + sc.prev;
+        cd->r    = sc.r;
+    }
+    l.first = s.first == LC_SAVED_NONE ? NULL : l.cbeg + s.first;
+
+    LC_TAKE(l.events, s.max_events*sizeof(lc_event));
+#ifdef LC_COMPACT_EVENTS
+    l.event_moved = NULL;
+    l.ued_base    = ued_base;
+    l.ued_size    = ued_size;
+#else
+    l.event_moved = lc_tell_cell_that_event_moved;
+    for ( cd = l.cbeg; cd < l.cend; cd++ )
+        for ( led = cd->bot; led < cd->top; led++ )
+            led->ued = (char *) ued_base + (size_t) led->ued * ued_size;
+#endif
+
+    l.min_class        = s.min_class;
+    l.num_classes      = s.num_classes;
+    l.max_events       = s.max_events;
+    l.r                = s.r;
+#ifdef LC_ROUND_OFF_ERRORS
+    l.eps              = s.eps;
+#endif
+    l.time_scale       = s.time_scale;
+    l.number_of_reorgs = s.number_of_reorgs;
+    l.number_of_checks = s.number_of_checks;
+    l.reorg_time       = s.reorg_time;
+    l.reorg_max_time   = s.reorg_max_time;
+    l.reorg_moved      = s.reorg_moved;
+    l.number_of_chunks = s.number_of_chunks;
+    l.rng              = &rand55_g;
+
+#if (LC_SELECTION==LC_SELECT_TREE)
+    if ( !( l.event_tree = malloc((l.max_events+1)*sizeof(lc_reactivity_t)) ) )
+        goto fail;
+    LC_TAKE(l.event_tree, (l.max_events+1)*sizeof(lc_reactivity_t));
+    for ( l.event_tree_step = 1; 2*l.event_tree_step <= l.max_events; )
+        l.event_tree_step *= 2;
+#endif
+#ifdef LC_CLASS_TREE
+    l.class_tree = calloc(l.num_classes+1, sizeof(lc_reactivity_t));
+    l.class_bits = calloc((l.num_classes+LC_BITS-1)/LC_BITS, sizeof(unsigned long));
+    if ( !l.class_tree || !l.class_bits )
+        goto fail;
+    LC_TAKE(l.class_tree, (l.num_classes+1)*sizeof(lc_reactivity_t));
+    LC_TAKE(l.class_bits, (l.num_classes+LC_BITS-1)/LC_BITS*sizeof(unsigned long));
+    for ( l.class_tree_step = 1; 2*l.class_tree_step <= (size_t) l.num_classes; )
+        l.class_tree_step *= 2;
+    l.occupied_classes = s.occupied_classes;
+#endif
+#ifdef LC_STATS
+    l.stats_min = s.stats_min;
+    l.stats_num = s.stats_num;
+    if ( !( l.stats = calloc(l.stats_num ? l.stats_num : 1, sizeof(lc_class_stats)) ) )
+        goto fail;
+    LC_TAKE(l.stats, l.stats_num*sizeof(lc_class_stats));
+#endif
+
+    *lc = l;
+    return p;
+
+fail:
+#ifdef LC_CLASS_TREE
+    free(l.class_bits);
+    free(l.class_tree);
+#endif
+#if (LC_SELECTION==LC_SELECT_TREE)
+    free(l.event_tree);
+#endif
+#ifdef LC_STATS
+    free(l.stats);
+#endif
+    free(l.events);
+    free(l.cbeg);
+    return NULL;
+#endif
+}  /* end -- lc_load */
+
+#undef LC_TAKE
+
 /*
 ** lc_check: checks the integrity of all classes
 ** parameters:
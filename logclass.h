@@ -59,6 +59,11 @@ extern "C" {
      lc_rand
      lc_knownchange
      lc_safechange
+     lc_update_batch
+     lc_stats
+     lc_stats_dump
+     lc_save
+     lc_load
      which constitute the user interface of the logclass package
      - Private function declarations:
      lc_delete
@@ -83,6 +88,7 @@ extern "C" {
 #include <time.h>
 #include <errno.h>
 #include <limits.h>   /* compiling with ULTRIX gcc results in warning that */
+#include <stdint.h>
 #include <float.h>    /* FLT_MAX has been redefined by float.h, but this   */
   /* does not seem to cause problems                   */
 #include <rand55.h>   /* random generator by Fricke/Knuth                  */
@@ -103,10 +109,28 @@ extern "C" {
 #define LC_LONG_DOUBLE 3
 #define LC_LONG_ULONG 4
 
-#define LC_REACTIVITY_TYPE LC_DOUBLE
-
+  /*
+     The type of reactivities is selected by defining LC_REACTIVITY_TYPE,
+     e.g. -DLC_REACTIVITY_TYPE=LC_ULONG, default is LC_DOUBLE.
+     With the integer types LC_ULONG and LC_LONG_ULONG class and total
+     reactivities are exact sums, no round-off errors have to be caught
+     and lc_reorg does not recalculate them; the total reactivity has to
+     stay below 2^63. Use them for integer rates times particle numbers.
+
+     LC_CLASS_OF(r,ci) sets ci to the class of r, 2^(ci-1) <= r < 2^ci,
+     lc_t_rand(st,r) draws uniformly in 0 <= x < r and
+     lc_reject(st,ci,r) is the rejection test of an event of reactivity r
+     in class ci, true with probability 1 - r/2^ci.
+
+     #define LC_FAST_EXPONENT with LC_DOUBLE to take the class index
+     straight from the IEEE-754 exponent bits instead of calling frexp,
+     and to compare the 53 bit mantissa of the reactivity with the top
+     53 bits of a random number instead of calling ldexp in the rejection
+     test. Both are branch free; zero (and denormals, which are out of
+     the class range anyway) get class 0 like with frexp.
+  */
 #ifndef LC_REACTIVITY_TYPE
-#define LC_REACTIVITY_TYPE LC_ULONG
+#define LC_REACTIVITY_TYPE LC_DOUBLE
 #endif
 
 #if (LC_REACTIVITY_TYPE==LC_DOUBLE)
@@ -115,41 +139,197 @@ extern "C" {
 #define lc_reactivity_min DBL_MIN
 #define LC_FORMAT "%lg"
 #define LC_ROUND_OFF_ERRORS
-#define lc_t_rand(r) (drand55()*(r))
+#define lc_t_rand(st,r) (drand55_r(st)*(r))
+#ifdef LC_FAST_EXPONENT
+#if (DBL_MANT_DIG != 53 || DBL_MAX_EXP != 1024 || ULONG_MAX < 0xffffffffffffffffUL)
+#error "LC_FAST_EXPONENT needs IEEE-754 doubles and a 64 bit rand55_t"
+#endif
+  typedef union LC_DOUBLE_BITS { double d; unsigned long long u; } lc_double_bits;
+#define LC_DOUBLE_BITS(r) (((lc_double_bits){ .d = (r) }).u)
+#define LC_BIASED_EXPONENT(r) ((int)(LC_DOUBLE_BITS(r) >> 52) & 0x7ff)
+#define LC_MANTISSA(r) ((LC_DOUBLE_BITS(r) & 0xfffffffffffffULL) | \
+                        ((unsigned long long)(LC_BIASED_EXPONENT(r) != 0) << 52))
+#define LC_CLASS_OF(r,ci) \
+  ((ci) = (LC_BIASED_EXPONENT(r) - 1022) & -(LC_BIASED_EXPONENT(r) != 0))
+#define lc_reject(st,ci,r) ((rand55_r(st) >> (rand55_modpwr-53)) >= LC_MANTISSA(r))
+#else
+#define LC_CLASS_OF(r,ci) frexp((r),&(ci))
+#define lc_reject(st,ci,r) (ldexp(drand55_r(st),(ci)) > (r))
+#endif
   //#warn "LC_REACTIVITY_TYPE==LC_DOUBLE"
 #endif
 
 #if (LC_REACTIVITY_TYPE==LC_LONG_ULONG)
   typedef unsigned long long lc_reactivity_t;
-#define lc_reactivity_max 18446744073709551615UL
+#define lc_reactivity_max ULLONG_MAX
 #define lc_reactivity_min 1
-#define LC_FORMAT "%Lu"
-#define lc_t_rand(r) lrand55(r)
+#define LC_FORMAT "%llu"
+#define LC_INTEGER_REACTIVITY
   //#warn "LC_REACTIVITY_TYPE==LC_LONG_ULONG"
 #endif
 
 #if (LC_REACTIVITY_TYPE==LC_LONG_DOUBLE)
-  typedef unsigned long lc_reactivity_t;
-#define lc_reactivity_max ULONG_MAX
-#define lc_reactivity_min 1
-#define LC_FORMAT "%Lf"
-#define lc_t_rand(r) (drand55()*(r))
+  typedef long double lc_reactivity_t;
+#define lc_reactivity_max LDBL_MAX
+#define lc_reactivity_min LDBL_MIN
+#define LC_FORMAT "%Lg"
+#define LC_ROUND_OFF_ERRORS
+#define LC_CLASS_OF(r,ci) frexpl((r),&(ci))
+#define lc_t_rand(st,r) (drand55_r(st)*(r))
+#define lc_reject(st,ci,r) (ldexpl(drand55_r(st),(ci)) > (r))
   //#warn "LC_REACTIVITY_TYPE==LC_LONG_DOUBLE"
 #endif
 
 #if (LC_REACTIVITY_TYPE==LC_ULONG)
   typedef unsigned long lc_reactivity_t;
-#define LC_REACTIVITY_TYPE LC_ULONG
 #define lc_reactivity_max ULONG_MAX
 #define lc_reactivity_min 1
 #define LC_FORMAT "%lu"
-#define lc_t_rand(r) lrand55(r)
+#define LC_INTEGER_REACTIVITY
   //#error "LC_REACTIVITY_TYPE==LC_ULONG"
 #endif
 
+#ifdef LC_INTEGER_REACTIVITY
+#define LC_CLASS_OF(r,ci) \
+  ((ci) = (r) ? (int)(sizeof(unsigned long long)*CHAR_BIT) - __builtin_clzll(r) : 0)
+#define lc_t_rand(st,r) lrand55_r((st),(r))
+#define lc_reject(st,ci,r) ((rand55_r(st) >> (rand55_modpwr-(ci))) >= (r))
+#endif
+
+#ifdef LC_ROUND_OFF_ERRORS
+#define LC_EPS(lc) ((lc)->eps)
+#else
+#define LC_EPS(lc) 0
+#endif
+
+  /*
+     #define LC_CLASS_TREE to select the class in lc_rand by a Fenwick tree over
+     the class reactivities and to keep track of the occupied classes by a
+     bitmap instead of the partially sorted list of classes.
+     Selecting a class and entering an event into an empty class then cost
+     O(log num_classes), independent of the number of classes in use.
+  */
+
+  /*
+     The sampler behind lc_rand is selected by defining LC_SELECTION, e.g.
+     -DLC_SELECTION=LC_SELECT_TREE, default is LC_SELECT_CLASSES:
+     - LC_SELECT_CLASSES: the dual-logarithmic classes of Fricke&Wendt,
+       a class is selected by the sorted list, or by a tree with
+       LC_CLASS_TREE, and an event within the class by rejection
+     - LC_SELECT_TREE: all events are kept in one class, lc_rand walks a
+       Fenwick tree over the reactivities of the leds, O(log n) per draw
+       and per change, no rejection
+     - LC_SELECT_LINEAR: all events are kept in one class, lc_rand sums up
+       the leds one by one, for systems of a few events only
+     The interface is the same for all of them. The one class variants
+     cannot be combined with LC_CLASS_TREE or LC_CLASS_CHUNKS.
+  */
+#define LC_SELECT_CLASSES 1
+#define LC_SELECT_TREE 2
+#define LC_SELECT_LINEAR 3
+
+#ifndef LC_SELECTION
+#define LC_SELECTION LC_SELECT_CLASSES
+#endif
+
+#if (LC_SELECTION!=LC_SELECT_CLASSES)
+#define LC_ONE_CLASS
+#if defined(LC_CLASS_TREE) || defined(LC_CLASS_CHUNKS)
+#error "LC_SELECT_TREE and LC_SELECT_LINEAR keep all events in one class, no LC_CLASS_TREE or LC_CLASS_CHUNKS"
+#endif
+#endif
+
+  /*
+     Only a window of classes is allocated, starting with LC_CLASS_WINDOW
+     classes. lc_getclass grows or slides it to the reactivities present,
+     so lc_reorg works on the classes in use only.
+  */
+#ifndef LC_CLASS_WINDOW
+#define LC_CLASS_WINDOW 16
+#endif
+
+  /*
+     #define LC_CLASS_CHUNKS to give every class its own leds in chunks of
+     2^LC_CHUNK_SHIFT leds. A class grows and shrinks by whole chunks and
+     leds never move to another place in memory, except to fill the gap
+     of a deleted led, so lc_store never has to reorganize all classes.
+     lc_reorg then only recalculates the reactivities.
+  */
+#ifndef LC_CHUNK_SHIFT
+#define LC_CHUNK_SHIFT 10
+#endif
+#define LC_CHUNK (1UL<<LC_CHUNK_SHIFT)
+
+  /*
+     #define LC_COMPACT_EVENTS for leds of 8 bytes instead of 16: the ued is
+     kept as 32 bit index into the user's array of event descriptors, which
+     has to be announced by lc_ued_array, and the event's reactivity as
+     float, or as uint32_t for the integer reactivity types. Class and
+     total reactivities keep the full type, reactivities are rounded to
+     the led type on entry, one outside its range stops the program. The link ued->led is stored directly into the
+     first element of the ued (see LC_DERIVED), lc->event_moved is not
+     called.
+  */
+#ifdef LC_COMPACT_EVENTS
+#ifdef LC_INTEGER_REACTIVITY
+  typedef uint32_t lc_event_r_t;
+#undef lc_reactivity_max
+#define lc_reactivity_max ((lc_reactivity_t)UINT32_MAX)
+#else
+  typedef float lc_event_r_t;
+#undef lc_reactivity_max
+#undef lc_reactivity_min
+#define lc_reactivity_max ((lc_reactivity_t)FLT_MAX)
+#define lc_reactivity_min ((lc_reactivity_t)FLT_MIN)
+#endif
+  /* the reactivity rounded to the led, exits if it does not fit: the
+     cast would wrap integers and turn large floats into inf, small ones
+     into 0 */
+  static inline lc_reactivity_t lc_event_r(lc_reactivity_t r){
+    if ( r > lc_reactivity_max
+#ifndef LC_INTEGER_REACTIVITY
+         || ( r > 0 && r < lc_reactivity_min )
+#endif
+       ) {
+      fprintf(stderr, "Reactivity out of range of the compact leds: " LC_FORMAT "\n", r);
+      fflush(NULL);
+      exit(1);
+    }
+    return (lc_reactivity_t)(lc_event_r_t) r;
+  }
+#define LC_EVENT_R(r) lc_event_r(r)
+#else
+  typedef lc_reactivity_t lc_event_r_t;
+#define LC_EVENT_R(r) (r)
+#endif
+
+  /*
+     #define LC_STATS to count, per class, the events drawn, the tries of the
+     rejection loop in lc_rand, the swaps of the class in the list of
+     classes and a histogram of the class size at each draw, buckets by
+     bit length of the size. The counters are kept for every class the
+     window has ever covered and are read by lc_stats or written by
+     lc_stats_dump. Without LC_STATS no counter is touched.
+  */
+#ifndef LC_STATS_BUCKETS
+#define LC_STATS_BUCKETS 32
+#endif
+
+  typedef struct LC_CLASS_STATS{
+    unsigned long long draws;      /* events drawn from the class         */
+    unsigned long long tries;      /* tries of the rejection loop         */
+    unsigned long long swaps;      /* moves ahead in the list of classes  */
+    unsigned long long occupancy[LC_STATS_BUCKETS];
+                                   /* draws with 2^(b-1) <= size < 2^b    */
+  } lc_class_stats;
+
   typedef struct LC_EVENT{
+#ifdef LC_COMPACT_EVENTS
+    uint32_t ued;              /* index of user's event descriptor   */
+#else
     void   *ued;               /* pointer to user's event descriptor */
-    lc_reactivity_t r;   /* reactivity of the event            */
+#endif
+    lc_event_r_t r;            /* reactivity of the event            */
   } lc_event;
 
   /* Type of the LC' event descriptors (leds), representing individual
@@ -159,7 +339,7 @@ extern "C" {
      Pointer to user's event descriptor is void *, so it may be cast to any
      pointer type and each user may choose her/his own type of ued.
 
-     The user-program needs to read element ued; it may read element r, but it
+     The user-program needs to read the ued by LC_UED(lc,led); it may read element r, but it
      MUST NOT assign to any element; the entries are maintained by the
      LC functions, so please KEEP YOUR HANDS OFF !!!
 
@@ -171,10 +351,18 @@ typedef struct LC_BASE{
   LC_DERIVED;
 } lc_base;
 
+#ifdef LC_COMPACT_EVENTS
+#define LC_UED(lc,led) ((void*)((lc)->ued_base+(size_t)(led)->ued*(lc)->ued_size))
+#else
+#define LC_UED(lc,led) ((led)->ued)
+#endif
+
 
 
   /* for lc_init */
+#ifndef LC_COMPACT_EVENTS
 extern void lc_tell_cell_that_event_moved(lc_event *lce);
+#endif
 
   /* useful macros */
 #define LC_GLOBAL_PTR() (&lc_g)
@@ -183,24 +371,47 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
 #define LC_MAIN_BEGIN(lcn,timescale) {lc_init(LC_GLOBAL_PTR(),(lcn),NULL,(timescale))
 #define LC_MAIN_END lc_clear(LC_GLOBAL_PTR());}
 
-#define LC_DRAW(type,source) lc_class *lc_c; lc_event *lc_e=lc_rand(LC_GLOBAL_PTR(),&lc_c); type * source=(type*)(lc_e->ued)
-#define LC_UPDATE_DRAWN(source) (source)->lc_ev=lc_knownchange(LC_GLOBAL_PTR(),lc_c,lc_e,(source),(lc_reactivity_t)LC_REACTIVITY(source));
+  /* the _IN variants work on an explicit lc_global, e.g. one per simulation */
+#define LC_DRAW_IN(lc,type,source) lc_class *lc_c; lc_event *lc_e=lc_rand((lc),&lc_c); type * source=(type*)LC_UED((lc),lc_e)
+#define LC_UPDATE_DRAWN_IN(lc,source) (source)->lc_ev=lc_knownchange((lc),lc_c,lc_e,(source),(lc_reactivity_t)LC_REACTIVITY(source));
 
-#define LC_UPDATE(name) (name)->lc_ev=lc_safechange(LC_GLOBAL_PTR(), (name)->lc_ev, (name), (lc_reactivity_t)LC_REACTIVITY(name));
+#define LC_UPDATE_IN(lc,name) (name)->lc_ev=lc_safechange((lc), (name)->lc_ev, (name), (lc_reactivity_t)LC_REACTIVITY(name));
 
-#define LC_TIME_UNIT() (LC_GLOBAL_PTR()->time_scale/LC_GLOBAL_PTR()->r)
-#define LC_TIME_STEP() (exp_rand55()*LC_TIME_UNIT())   /* draw time step */
+#define LC_TIME_UNIT_IN(lc) ((lc)->time_scale/(lc)->r)
+#define LC_TIME_STEP_IN(lc) (exp_rand55_r((lc)->rng)*LC_TIME_UNIT_IN(lc))   /* draw time step */
+
+#define LC_DRAW(type,source) LC_DRAW_IN(LC_GLOBAL_PTR(),type,source)
+#define LC_UPDATE_DRAWN(source) LC_UPDATE_DRAWN_IN(LC_GLOBAL_PTR(),source)
+#define LC_UPDATE(name) LC_UPDATE_IN(LC_GLOBAL_PTR(),name)
+#define LC_TIME_UNIT() LC_TIME_UNIT_IN(LC_GLOBAL_PTR())
+#define LC_TIME_STEP() LC_TIME_STEP_IN(LC_GLOBAL_PTR())
 
 #define LC_EVENT_BEFORE(time,now,time_step) ( (time)-(now)<(time_step))
 
 
   /*--------------------------------------------------------------------------*/
 
-  typedef struct LC_CLASS{ lc_event        *bot, *top;
+  typedef struct LC_CLASS{
+#ifdef LC_CLASS_CHUNKS
+    lc_event       **chunk;
+    size_t           size;
+    unsigned         chunks, table;
+#else
+    lc_event        *bot, *top;
+#endif
     lc_reactivity_t           r;
     struct LC_CLASS *next, *prev;
   } lc_class;
 
+  /* i-th led of class cd, i is evaluated twice */
+#ifdef LC_CLASS_CHUNKS
+#define LC_CLASS_SIZE(cd)  ((cd)->size)
+#define LC_CLASS_LED(cd,i) ((cd)->chunk[(i)>>LC_CHUNK_SHIFT]+((i)&(LC_CHUNK-1)))
+#else
+#define LC_CLASS_SIZE(cd)  ((size_t)((cd)->top-(cd)->bot))
+#define LC_CLASS_LED(cd,i) ((cd)->bot+(i))
+#endif
+
   /* Type of class descriptors, each describing one class, see Fricke&Wendt.
 
      A class L[z] (dual-logarithmic class) is a set of events e whose
@@ -212,13 +423,17 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
      - bot : pointer to array F[], i.e. its first element
      - top : pointer to the first led "behind" this array, i.e. top does not
      point to a valid led, but serves as upper limit
+     - chunk, size, chunks, table: instead of bot and top with
+     LC_CLASS_CHUNKS, the table of chunks allocated for F[], the number
+     of leds in F[], the number of chunks and the size of the table
      - r   : reactivity of the class
      - next: links each class to its successor in a list, which is
      (imperfectly) sorted by class reactivity (descending order)
 
      The type lc_class is made public only to enable function lc_rand to
      pass a pointer to a class descriptor to lc_knownchange via the user-
-     program.
+     program. Class descriptors move when the window of classes moves,
+     so the pointer is valid until the next call of an lc function only.
      Direct contact to these class descriptors should not be necessary,
      so please KEEP YOUR HANDS OFF !!!
   */
@@ -227,6 +442,7 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
 
   typedef struct LC_GLOBAL  {
 		lc_class *cbeg, *cend, *first;
+    lc_event *events;
     int       min_class, num_classes;
     size_t    max_events;
     lc_reactivity_t    r;
@@ -236,12 +452,33 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
 #endif
     lc_reorg_t number_of_reorgs;
     size_t number_of_checks;
+    double    reorg_time, reorg_max_time;
+    size_t    reorg_moved, number_of_chunks;
     void      (*event_moved)(lc_event *);
+    rand55_state *rng;
+#ifdef LC_COMPACT_EVENTS
+    char     *ued_base;            /* array of ueds, see lc_ued_array  */
+    size_t    ued_size;
+#endif
+#if (LC_SELECTION==LC_SELECT_TREE)
+    lc_reactivity_t *event_tree;   /* Fenwick tree over led reactivities  */
+    size_t    event_tree_step;     /* highest power of 2 <= max_events    */
+#endif
+#ifdef LC_STATS
+    lc_class_stats *stats;         /* counters of classes stats_min ..    */
+    int       stats_min, stats_num;
+#endif
+#ifdef LC_CLASS_TREE
+    lc_reactivity_t *class_tree;   /* Fenwick tree over class reactivities */
+    unsigned long   *class_bits;   /* bit set for each class not empty     */
+    size_t    class_tree_step;     /* highest power of 2 <= num_classes    */
+    int       occupied_classes;
+#endif
   } lc_global;
 
-    lc_global lc_g;
+  extern lc_global lc_g;   /* define it by LC_GLOBAL_DEF if you need it */
+
 
-    
   /* The global data structure of LC containing all information required
      by LC' functions to operate.
 
@@ -261,11 +498,14 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
      cbeg[n] < cend, 0 <= n ( < num_classes )
      first  : pointer to first element in linked list of class descriptors,
      i.e. class where lc_rand starts search
-     min_class  : index of lowest class
+     events : the array of leds, cbeg->bot may lie above after the window
+     of classes has been moved up
+     min_class  : index of lowest class in the window
      num_classes: number of class descriptors allocated, i.e. number of elements
      in array beginning at cbeg;
-     event reactivities < 2^(min_class-1) are treated as zero,
-     reactivities >= 2^(min_class+num_classes) cause an overflow
+     reactivities outside 2^(min_class-1) .. 2^(min_class+num_classes-1)
+     move the window, reactivities out of the range of lc_reactivity_t
+     cause an overflow
      max_events : number of LC event descriptors (leds) allocated, i.e.
      maximum number of events that can be handled
      r          : total reactivity of the system, 1/r is mean of the
@@ -273,8 +513,24 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
      eps        : lowest reactivity not treated as zero, i.e. 2^(min_class-1)
      number_of_reorgs: counts how often memory has been reorganized since
      initialization
+     reorg_time, reorg_max_time: seconds spent in lc_reorg in total and in
+     the longest single call, i.e. the worst stall of lc_store
+     reorg_moved     : leds moved by lc_reorg, i.e. calls of event_moved
+     number_of_chunks: chunks allocated with LC_CLASS_CHUNKS
      *event_moved    : pointer to function defined in user-program to update
      the link ued->led
+     ued_base, ued_size: array of the ueds if LC_COMPACT_EVENTS is defined
+     *rng            : random generator state used by lc_rand and
+     LC_TIME_STEP, set to the process-wide rand55_g by lc_init; point
+     it to a private rand55_state to run several simulations at once
+     class_tree, class_bits, class_tree_step, occupied_classes:
+     index of the classes if LC_CLASS_TREE is defined, class_tree[i] holds
+     the sum of the reactivities of classes i-(i&-i) .. i-1
+     event_tree, event_tree_step: index of the leds with LC_SELECT_TREE,
+     event_tree[i] holds the sum of the reactivities of leds
+     i-(i&-i) .. i-1 of lc->events
+     stats, stats_min, stats_num: counters of the classes stats_min ..
+     stats_min+stats_num-1 if LC_STATS is defined, see lc_stats
      err_file        : name of file for error messages
      *err_proc       : pointer to function defined in user-program to "wrap
      things up" before exiting due to error in LC
@@ -337,6 +593,26 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
 
   /*--------------------------------------------------------------------------*/
 
+  void lc_ued_array(lc_global *lc, void *base, size_t size);
+
+  /* Task:
+     - announces the array of ueds, needed with LC_COMPACT_EVENTS only
+
+     Arguments:
+     - lc   : pointer to global data structure
+     - base : first ued, all ueds entered have to lie in this array
+     - size : size of one ued in bytes
+
+     Called by:
+     user-program, before the first event is entered
+
+     Remarks:
+     - with LC_COMPACT_EVENTS at most 2^32 ueds may be addressed and
+     LC_DERIVED has to be the first element of the ued
+  */
+
+  /*--------------------------------------------------------------------------*/
+
   lc_event *lc_enter(lc_global *lc, void *ued, lc_reactivity_t r);
   /*
     shortcut if the macro LC_REACTIVITY computes the reactivity
@@ -497,6 +773,39 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
      ued->led_ptr = lc_safechange(lc, led, ued, r);
   */
 
+  /*--------------------------------------------------------------------------*/
+
+  void lc_update_batch(lc_global *lc, void **ueds, const lc_reactivity_t *r,
+                       size_t n);
+
+  /* Task:
+     - set the NEW reactivities r[i] of the n events ueds[i], as n calls of
+     lc_safechange would do, e.g. for all cells changed by one Markov step
+     - events remaining in their class are updated first, their changes
+     of the total reactivity are summed up and added once
+     - then all events leaving their class are deleted, and only then
+     stored into their new classes, so the leds freed by the deletions
+     are available; if a class is still short of room for the events
+     going to it, memory is reorganized once, reserving room for all of
+     them, before the first one is stored
+
+     Arguments:
+     - lc   : pointer to global data structure
+     - ueds : the ueds, which have to start with LC_DERIVED
+     - r    : NEW reactivities of the events
+     - n    : number of events
+
+     Called by:
+     user-program
+
+     Calls:
+     lc_getclass, lc_delete, lc_store
+
+     Remarks:
+     - updates the links ued -> led itself
+     - an ued may appear more than once, the last reactivity counts
+  */
+
 
   /* ========================================================================= */
   /*                                                                           */
@@ -665,6 +974,90 @@ extern void lc_tell_cell_that_event_moved(lc_event *lce);
      ued->led_ptr = lc_unknownchange(lc, led, ued, r);
   */
 
+  /*--------------------------------------------------------------------------*/
+
+  size_t lc_stats(const lc_global *lc, int *min_class,
+                  const lc_class_stats **stats);
+
+  /* Task:
+     - gives access to the counters kept with LC_STATS
+
+     Arguments:
+     - lc        : pointer to global data structure
+     - min_class : set to the class of (*stats)[0], i.e. reactivities
+     2^(min_class-1) <= r < 2^min_class
+     - stats     : set to the array of counters, valid until the next call
+     of an lc function
+
+     Returns:
+     - number of classes in *stats, 0 if compiled without LC_STATS
+
+     Called by:
+     user-program
+  */
+
+  /*--------------------------------------------------------------------------*/
+
+  int lc_stats_dump(const lc_global *lc, const char *filename);
+
+  /* Task:
+     - writes the reorganisation counters and, with LC_STATS, one line per
+     class drawn from to filename as text, columns described in the header
+
+     Arguments:
+     - lc       : pointer to global data structure
+     - filename : file to write, "-" for stdout
+
+     Returns:
+     - 0 on success, -1 if the file could not be written (errno is set)
+
+     Called by:
+     user-program
+  */
+
+  /*--------------------------------------------------------------------------*/
+
+  int lc_save(const lc_global *lc, FILE *f, const void *ued_base, size_t ued_size);
+
+  /* Task:
+     - writes classes, leds and counters to f in binary, pointers as
+     indices: leds into lc->events, ueds into the array of ued_size
+     bytes at ued_base, which has to hold all ueds
+
+     Returns:
+     - 0 on success, -1 on a write error or with LC_CLASS_CHUNKS, whose
+     chunks are not saved
+
+     Called by:
+     user-program
+
+     Remark:
+     the layout depends on the compile time options and lc_reactivity_t,
+     read it with the same build only
+  */
+
+  /*--------------------------------------------------------------------------*/
+
+  const char *lc_load(lc_global *lc, const char *p, const char *end,
+                      void *ued_base, size_t ued_size);
+
+  /* Task:
+     - sets up lc, instead of lc_init, from what lc_save has written to the
+     memory p .. end, e.g. a mapped file, and points the leds to the ueds
+     of the array at ued_base; the classes are taken as they were, not
+     rebuilt by lc_enter, so lc_rand continues exactly as after lc_save
+
+     Returns:
+     - pointer behind the data read, NULL if it ends early, a class index
+     or led offset is out of range or memory runs out, lc is untouched then
+
+     Called by:
+     user-program
+
+     Remark:
+     the links ued->led are the user's, lc->rng is set to rand55_g
+  */
+
   /*
   ** lc_check: checks the integrity of all classes
   ** parameters:
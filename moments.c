@@ -0,0 +1,112 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Walker totals and moments, see moments.h. The steppers update them
+  through the inline functions of the header, here they are set up and
+  counted from scratch.
+*/
+
+#include <string.h>
+#include <moments.h>
+
+/* all sums over all cells */
+static void moments_count(sm_context *ctx){
+  sm_moments *m=ctx->moments;
+  const int dim=ctx->topology->dimension;
+
+  m->walkers=0;
+  memset(m->species, 0, sizeof(m->species));
+  memset(m->first, 0, dim*sizeof(long));
+  memset(m->second, 0, dim*sizeof(long));
+  for(size_t i=0; i<ctx->number_of_cells; i++){
+    const cell *c=ctx->cells+i;
+    long n=0;
+    for(int s=0; s<SM_SPECIES; s++){
+      long k=(long) species(c, s);
+      m->species[s]+=k;
+      n+=k;
+    }
+    if(n){
+      m->walkers+=n;
+      moments_add(m, ctx->topology, i, n);
+    }
+  }
+  m->valid=1;
+}
+
+int moments_start(sm_context *ctx){
+  const int dim=ctx->topology->dimension;
+  sm_moments *m;
+
+  if(ctx->moments){
+    ctx->moments->valid=0;
+    return 0;
+  }
+  m=calloc(1, sizeof(sm_moments));
+  if(!m)
+    return -1;
+  m->first=calloc(dim, sizeof(long));
+  m->second=calloc(dim, sizeof(long));
+  m->edge=calloc(dim, sizeof(size_t));
+  if(!m->first || !m->second || !m->edge){
+    free(m->first);
+    free(m->second);
+    free(m->edge);
+    free(m);
+    return -1;
+  }
+  for(int d=0; d<dim; d++)
+    m->edge[d]=ctx->topology->sizes[d+1]/ctx->topology->sizes[d];
+  ctx->moments=m;
+  return 0;
+}
+
+void moments_stop(sm_context *ctx){
+  sm_moments *m=ctx->moments;
+
+  if(!m)
+    return;
+  free(m->first);
+  free(m->second);
+  free(m->edge);
+  free(m);
+  ctx->moments=NULL;
+}
+
+void moments_invalidate(sm_context *ctx){
+  if(ctx->moments)
+    ctx->moments->valid=0;
+}
+
+const sm_moments *walk_moments(sm_context *ctx){
+  if(!ctx->moments)
+    return NULL;
+  if(!ctx->moments->valid)
+    moments_count(ctx);
+  return ctx->moments;
+}
+
+double moments_msd(const sm_moments *m, int d, const double *origin){
+  double mean, c;
+
+  if(!m->walkers)
+    return 0;
+  mean=(double) m->first[d]/m->walkers;
+  c=origin ? origin[d] : mean;
+  return (double) m->second[d]/m->walkers-2*c*mean+c*c;
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MOMENTS_H___
+#define __MOMENTS_H___
+
+#include <sagemarkov.h>
+
+/*
+** Totals and spatial moments of the walkers, kept up to date per step.
+**
+** markov_step and nsm_step read the species of the cell stepped before
+** and after reaction_step or diffusion_step and add the difference, the
+** walkers that left the source of a diffusion step arrived at its
+** destination. The sums are integers and stay exact. The coordinate x[d]
+** of a cell is the one of coords() in markovian.spyx,
+** (index % sizes[d+1]) / sizes[d].
+**
+** A cell changed from outside, through update_reactivity, and the
+** approximate engines of leap.c mark the moments invalid, the next
+** walk_moments counts them again over all cells.
+**
+** The model has to provide SM_SPECIES and species, the walkers of one
+** kind in a cell.
+*/
+typedef struct SM_MOMENTS{
+  int valid;
+  long walkers;                 /* sum of all species                     */
+  long species[SM_SPECIES];
+  long *first, *second;         /* [d], sums over the walkers of x[d] and
+                                   x[d]*x[d]                              */
+  size_t *edge;                 /* [d], sizes[d+1]/sizes[d]               */
+} sm_moments;
+
+/* starts keeping the moments of ctx, 0, or -1 if out of memory */
+int moments_start(sm_context *ctx);
+
+void moments_stop(sm_context *ctx);
+
+/* the moments of ctx, counted again if invalid; NULL if not started */
+const sm_moments *walk_moments(sm_context *ctx);
+
+/*
+** mean square displacement of the walkers in dimension d from origin,
+** from their mean if origin is NULL; 0 without walkers
+*/
+double moments_msd(const sm_moments *m, int d, const double *origin);
+
+/* n walkers appeared at cell i, or left it for n < 0 */
+static inline void moments_add(sm_moments *m, const sm_topology *t, size_t i, long n){
+  size_t q=i, next;
+
+  for(int d=0; d<t->dimension; d++){
+    long x;
+    next=q/m->edge[d];
+    x=(long) (q-next*m->edge[d]);
+    m->first[d]+=n*x;
+    m->second[d]+=n*x*x;
+    q=next;
+  }
+}
+
+/* n walkers went from cell from to cell to, only the coordinates changed */
+static inline void moments_move(sm_moments *m, const sm_topology *t, size_t from, size_t to, long n){
+  size_t qf=from, qt=to, nf, nt;
+  size_t off = to > from ? to-from : from-to;
+
+  /* a hop to a neighbour moves one coordinate by one, unless it wraps */
+  for(int d=0; d<t->dimension; d++)
+    if(off == t->sizes[d]){
+      long x=(long) ((d ? from/t->sizes[d] : from) % m->edge[d]);
+      long y = to > from ? x+1 : x-1;
+      if(y < 0 || y >= (long) m->edge[d])
+        break;
+      m->first[d]+=n*(y-x);
+      m->second[d]+=n*(y*y-x*x);
+      return;
+    }
+
+  for(int d=0; d<t->dimension && qf != qt; d++){
+    long xf, xt;
+    nf=qf/m->edge[d];
+    nt=qt/m->edge[d];
+    xf=(long) (qf-nf*m->edge[d]);
+    xt=(long) (qt-nt*m->edge[d]);
+    m->first[d]+=n*(xt-xf);
+    m->second[d]+=n*(xt*xt-xf*xf);
+    qf=nf;
+    qt=nt;
+  }
+}
+
+static inline void moments_before(const cell *source, unsigned long *before){
+  for(int s=0; s<SM_SPECIES; s++)
+    before[s]=species(source, s);
+}
+
+/* source has been stepped, by a reaction if dest is source */
+static inline void moments_step(sm_context *ctx, const cell *source, const cell *dest,
+                                const unsigned long *before){
+  sm_moments *m=ctx->moments;
+  long n=0;
+
+  for(int s=0; s<SM_SPECIES; s++){
+    long k=(long) species(source, s)-(long) before[s];
+    n+=k;
+    if(dest == source)
+      m->species[s]+=k;
+  }
+  if(dest == source){
+    m->walkers+=n;
+    moments_add(m, ctx->topology, source-ctx->cells, n);
+  }
+  else
+    moments_move(m, ctx->topology, source-ctx->cells, dest-ctx->cells, -n);
+}
+
+#endif
@@ -0,0 +1,168 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Next-subvolume engine, see nsm.h.
+
+  The firing times are absolute Markov times. A cell whose reactivity
+  changed gets a fresh exponential time from now on, which is exact as
+  the waiting times are memoryless. Cells of reactivity 0 never fire,
+  their time is INFINITY.
+*/
+
+#include <math.h>
+#include <nsm.h>
+#include <recorder.h>
+#include <moments.h>
+
+static void nsm_swap(sm_nsm *nsm, size_t a, size_t b){
+  size_t ca=nsm->heap[a], cb=nsm->heap[b];
+  nsm->heap[a]=cb;
+  nsm->heap[b]=ca;
+  nsm->pos[cb]=a;
+  nsm->pos[ca]=b;
+}
+
+/* restore the heap order around position p after tau has changed */
+static void nsm_sift(sm_nsm *nsm, size_t n, size_t p){
+  size_t child;
+
+  while(p && nsm->tau[nsm->heap[p]] < nsm->tau[nsm->heap[(p-1)/2]]){
+    nsm_swap(nsm, p, (p-1)/2);
+    p=(p-1)/2;
+  }
+  while((child=2*p+1) < n){
+    if(child+1 < n && nsm->tau[nsm->heap[child+1]] < nsm->tau[nsm->heap[child]])
+      child++;
+    if(nsm->tau[nsm->heap[child]] >= nsm->tau[nsm->heap[p]])
+      break;
+    nsm_swap(nsm, p, child);
+    p=child;
+  }
+}
+
+/* draw the firing time of cell i from time now on from rng, update the total */
+static void nsm_schedule(sm_context *ctx, rand55_state *rng, size_t i, double now){
+  sm_nsm *nsm=ctx->nsm;
+  lc_reactivity_t r=(lc_reactivity_t)LC_REACTIVITY(ctx->cells+i);
+
+  nsm->total+=r-nsm->r[i];
+  nsm->r[i]=r;
+  nsm->tau[i] = r>0 ? now+exp_rand55_r(rng)*ctx->timescale/r : INFINITY;
+}
+
+int nsm_start(sm_context *ctx){
+  const size_t n=ctx->number_of_cells;
+  sm_nsm *nsm=ctx->nsm;
+  sm_sweep sweep;
+
+  if(!nsm){
+    nsm=calloc(1, sizeof(sm_nsm));
+    if(!nsm)
+      return -1;
+    nsm->tau =calloc(n+1, sizeof(double));
+    nsm->heap=calloc(n+1, sizeof(size_t));
+    nsm->pos =calloc(n+1, sizeof(size_t));
+    nsm->r   =calloc(n+1, sizeof(lc_reactivity_t));
+    if(!nsm->tau || !nsm->heap || !nsm->pos || !nsm->r){
+      ctx->nsm=nsm;
+      nsm_free(ctx);
+      return -1;
+    }
+    ctx->nsm=nsm;
+  }
+
+  nsm->total=0;
+  nsm->tau[n]=INFINITY;         /* an empty lattice never fires */
+  sweep_start(ctx, &sweep);
+  for(size_t i=0; i<n; i++){
+    nsm->r[i]=0;
+    nsm_schedule(ctx, sweep_cell(&sweep, i), i, ctx->markov_time);
+    nsm->heap[i]=i;
+    nsm->pos[i]=i;
+  }
+  /* heapify bottom up */
+  for(size_t p=n/2; p-- > 0; )
+    nsm_sift(nsm, n, p);
+  return 0;
+}
+
+void nsm_free(sm_context *ctx){
+  sm_nsm *nsm=ctx->nsm;
+
+  if(!nsm)
+    return;
+  free(nsm->tau);
+  free(nsm->heap);
+  free(nsm->pos);
+  free(nsm->r);
+  free(nsm);
+  ctx->nsm=NULL;
+}
+
+void nsm_stop(sm_context *ctx){
+  if(!ctx->nsm)
+    return;
+  nsm_free(ctx);
+
+  /* the cells have changed behind the back of the logclass structure */
+  for(size_t i=0; i<ctx->number_of_cells; i++)
+    LC_UPDATE_IN(&ctx->lc, ctx->cells+i);
+}
+
+void nsm_update(sm_context *ctx, size_t index){
+  nsm_schedule(ctx, &ctx->rng, index, ctx->markov_time);
+  nsm_sift(ctx->nsm, ctx->number_of_cells, ctx->nsm->pos[index]);
+}
+
+double nsm_step(sm_context *ctx){
+  sm_nsm *nsm=ctx->nsm;
+  const size_t n=ctx->number_of_cells;
+  cell *source=ctx->cells+nsm->heap[0];
+  double now=nsm->tau[nsm->heap[0]];
+
+  if(now > ctx->record_at)
+    recorder_sample(ctx, now);
+
+  lc_reactivity_t reaction  = reaction_reactivity(source);
+  lc_reactivity_t diffusion = diffusion_reactivity(source);
+  unsigned long before[SM_SPECIES];
+
+  if(ctx->moments)
+    moments_before(source, before);
+
+  if( lc_t_rand(&ctx->rng, reaction + diffusion) < reaction ){
+    // reaction step
+    reaction_step(source);
+    if(ctx->moments)
+      moments_step(ctx, source, source, before);
+  } else {
+    // diffusion step, the destination is rescheduled, too
+    cell *dest = diffusion_step(ctx, source);
+    size_t d = dest - ctx->cells;
+
+    if(ctx->moments)
+      moments_step(ctx, source, dest, before);
+
+    nsm_schedule(ctx, &ctx->rng, d, now);
+    nsm_sift(nsm, n, nsm->pos[d]);
+  }
+  nsm_schedule(ctx, &ctx->rng, source - ctx->cells, now);
+  nsm_sift(nsm, n, nsm->pos[source - ctx->cells]);
+
+  return now - ctx->markov_time;
+}
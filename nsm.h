@@ -0,0 +1,46 @@
+#ifndef __NSM_H___
+#define __NSM_H___
+
+#include <randomwalk.h>
+
+/*
+** Next-subvolume method (Elf & Ehrenberg) as an alternative to the
+** logclass time stepping of markov_step.
+**
+** Every cell gets a putative firing time, exponentially distributed with
+** its reactivity LC_REACTIVITY(cell)/timescale, the cells are kept in an
+** indexed binary heap ordered by these times. A step fires the cell on top
+** and reschedules only the source and the destination, with the same
+** reaction_step, diffusion_step and random_neighbour of the model.
+**
+** While the engine runs, ctx->lc is not updated; nsm_stop enters all
+** cells into it again.
+*/
+typedef struct SM_NSM{
+  double *tau;                  /* putative firing time of each cell      */
+  size_t *heap;                 /* cells, heap[0] fires next              */
+  size_t *pos;                  /* position of each cell in heap          */
+  lc_reactivity_t *r;           /* reactivity the cell was scheduled with */
+  lc_reactivity_t total;        /* sum of r, what ctx->lc.r is otherwise  */
+} sm_nsm;
+
+/*
+** switches ctx to the next-subvolume engine and schedules all cells from
+** the current time on, again if it runs already, e.g. after the initial
+** conditions have been changed. Returns 0, or -1 if out of memory.
+*/
+int nsm_start(sm_context *ctx);
+
+/* switches back to the logclass engine, which is brought up to date */
+void nsm_stop(sm_context *ctx);
+
+/* drops the engine without bringing ctx->lc up to date, before destroy_walk */
+void nsm_free(sm_context *ctx);
+
+/* reschedules cell index after it has been changed from outside */
+void nsm_update(sm_context *ctx, size_t index);
+
+/* fires the next cell, returns the time step like markov_step */
+double nsm_step(sm_context *ctx);
+
+#endif
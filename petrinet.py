@@ -51,6 +51,20 @@ class Model(object):
 
         return reactants_template.substitute(reactants=reactants)
 
+    def species_header(self):
+        header_template = Template(self.template.species.header)
+        return header_template.substitute(count=len(self.data.molecules))
+
+    def species(self):
+        body_template = Template(self.template.species.body)
+        case_template = Template(self.template.species.case)
+
+        cases = ""
+        for i, r in enumerate(self.data.molecules):
+            cases += case_template.substitute(index=i, name=r.molecule.name)
+
+        return body_template.substitute(cases=cases)
+
     def educt_factor(self, educts):
         mult = ""
         result = ""
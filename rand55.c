@@ -18,10 +18,12 @@
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "rand55.h"
 #include "gauss55.h"
 
 #include "rand55static.c"
+#include "ziggurat55static.c"
 
 double 	_gauss_reject55[rand55_N_GAUSSHALF]={
   /* 0 */ .79788456080286535588 ,
@@ -68,20 +70,34 @@ double 	_gauss_reject55[rand55_N_GAUSSHALF]={
 
 double gauss_rand55(void)
 {
-  register	alias55, sign;
+  return gauss_rand55_r(&rand55_g);
+}
+
+double gauss_rand55_r(rand55_state *st)
+{
+#ifdef RAND55_ZIGGURAT
+  return gauss_zig_rand55_r(st);
+#else
+  return gauss_alias_rand55_r(st);
+#endif
+}
+
+double gauss_alias_rand55_r(rand55_state *st)
+{
+  register int	alias55, sign;
 
-  alias55 = (  ( (int)rand55() ) & (127) );
+  alias55 = (  ( (int)rand55_r(st) ) & (127) );
 
   sign = alias55 & 64;
   alias55 &= 63;
 
-  if( rand55_g_prob[alias55] < drand55() )
+  if( rand55_g_prob[alias55] < drand55_r(st) )
     alias55=rand55_g_else[alias55];
   if(  alias55 < rand55_N_GAUSSHALF )
     if( sign )
-      return (alias55+drand55())*0.125;
+      return (alias55+drand55_r(st))*0.125;
     else
-      return -(alias55+drand55())*0.125;
+      return -(alias55+drand55_r(st))*0.125;
   else
     {
       double x, y, dy;
@@ -90,8 +106,8 @@ double gauss_rand55(void)
       dy = _gauss_reject55[alias55]
 	- _gauss_reject55[alias55+1];
       do{
-	x=(alias55+drand55()) * 0.125;
-	y= dy * drand55();
+	x=(alias55+drand55_r(st)) * 0.125;
+	y= dy * drand55_r(st);
       }
       while ( (*_gauss_reject55) * exp(-x*x*0.5)
 	      -	_gauss_reject55[alias55+1] < y);
@@ -100,105 +116,418 @@ double gauss_rand55(void)
     }
 }
 
+/*	the ziggurat, rejected by the rectangle of layer u>>56 or u>>57:
+*	layer 0 continues into the tail, the others test the wedge
+*	between f[i] and f[i+1] and draw again if it misses.
+*/
+double exp_zig_rand55_wedge(rand55_state *st, rand55_t u)
+{
+  for(;;) {
+    rand55_t j = u & rand55_Z56;
+    int      i = (int)(u >> 56);
+    double   x = j * rand55_zexp_w[i];
+
+    if( j < rand55_zexp_k[i] )
+      return x;
+    if( i == 0 )   /* the tail beyond r is exponential again */
+      return rand55_zexp_r + exp_zig_rand55_r(st);
+    if( rand55_zexp_f[i] + drand55_r(st) * (rand55_zexp_f[i+1] - rand55_zexp_f[i])
+	< exp(-x) )
+      return x;
+    u = rand55_r(st);
+  }
+}
+
+double gauss_zig_rand55_wedge(rand55_state *st, rand55_t u)
+{
+  for(;;) {
+    rand55_t j = u & rand55_Z56;
+    int      i = (int)(u >> 57);
+    double   x = j * rand55_zgauss_w[i];
+
+    if( j >= rand55_zgauss_k[i] ) {
+      if( i == 0 ) {   /* Marsaglia's tail beyond r */
+	double y;
+	do {
+	  x = -log( 1.0 - drand55_r(st) ) / rand55_zgauss_r;
+	  y = -log( 1.0 - drand55_r(st) );
+	} while( y + y < x * x );
+	x += rand55_zgauss_r;
+      }
+      else if( rand55_zgauss_f[i] + drand55_r(st) * (rand55_zgauss_f[i+1] - rand55_zgauss_f[i])
+	       >= exp(-0.5 * x * x) ) {
+	u = rand55_r(st);
+	continue;
+      }
+    }
+    return (u >> 56 & 1) ? -x : x;
+  }
+}
+
+/*	log k!, a table for small k, else Stirling's series */
+static double rand55_logfact(double k)
+{
+  static const double lf[16] = {
+    0, 0, 0.69314718055994495, 1.7917594692280554,
+    3.1780538303479449, 4.7874917427820467, 6.5792512120101021,
+    8.5251613610654147, 10.604602902745249, 12.801827480081467,
+    15.104412573075514, 17.502307845873887, 19.987214495661885,
+    22.552163853123421, 25.191221182738683, 27.89927138384089 };
+  double r;
+
+  if( k < 16 )
+    return lf[(int) k];
+  r = 1 / k;
+  return (k + 0.5) * log(k) - k + 0.91893853320467274
+    + r * (1.0/12 - r * r * (1.0/360 - r * r / 1260));
+}
+
+/*	Poisson variate of mean mu: inversion by sequential search for small
+*	mu, else PTRS, W. Hoermann, The transformed rejection method for
+*	generating Poisson random variables, Insurance: Math. Econ. 12 (1993).
+*/
+unsigned long poisson_rand55_r(rand55_state *st, double mu)
+{
+  if( mu <= 0 )
+    return 0;
+  if( mu < 10 ) {
+    double p = exp(-mu), u = drand55_r(st);
+    unsigned long k = 0;
+
+    while( u > p ) {
+      u -= p;
+      k++;
+      p *= mu / k;
+      if( p < 1e-300 )   /* u was above the rounded sum */
+	return poisson_rand55_r(st, mu);
+    }
+    return k;
+  }
+  else {
+    double slam = sqrt(mu), loglam = log(mu);
+    double b = 0.931 + 2.53 * slam, a = -0.059 + 0.02483 * b;
+    double invalpha = 1.1239 + 1.1328 / (b - 3.4), vr = 0.9277 - 3.6224 / (b - 2);
+
+    for(;;) {
+      double u = drand55_r(st) - 0.5, v = drand55_r(st), us = 0.5 - fabs(u);
+      double k = floor( (2 * a / us + b) * u + mu + 0.43 );
+
+      if( us >= 0.07 && v <= vr )
+	return (unsigned long) k;
+      if( k < 0 || (us < 0.013 && v > us) )
+	continue;
+      if( log(v) + log(invalpha) - log(a / (us * us) + b)
+	  <= -mu + k * loglam - rand55_logfact(k) )
+	return (unsigned long) k;
+    }
+  }
+}
+
+/*	binomial variate: inversion for small n*p, else BTRS, W. Hoermann,
+*	The generation of binomial random variates, J. Stat. Comput. Simul.
+*	46 (1993); p > 1/2 is drawn as n minus the count of failures.
+*/
+unsigned long binomial_rand55_r(rand55_state *st, unsigned long n, double p)
+{
+  double q;
+
+  if( p > 0.5 )
+    return n - binomial_rand55_r(st, n, 1 - p);
+  if( n == 0 || p <= 0 )
+    return 0;
+  q = 1 - p;
+  if( n * p < 10 ) {
+    double s = p / q, a = (n + 1) * s, r = pow(q, (double) n), u = drand55_r(st);
+    unsigned long x = 0;
+
+    while( u > r && x < n ) {
+      u -= r;
+      x++;
+      r *= a / x - s;
+    }
+    return x;
+  }
+  else {
+    double spq = sqrt(n * p * q), b = 1.15 + 2.53 * spq;
+    double a = -0.0873 + 0.0248 * b + 0.01 * p;
+    double c = n * p + 0.5, vr = 0.92 - 4.2 / b;
+    double alpha = (2.83 + 5.1 / b) * spq, lpq = log(p / q);
+    double m = floor((n + 1) * p), h = rand55_logfact(m) + rand55_logfact(n - m);
+
+    for(;;) {
+      double u = drand55_r(st) - 0.5, v = drand55_r(st), us = 0.5 - fabs(u);
+      double k = floor( (2 * a / us + b) * u + c );
+
+      if( k < 0 || k > n )
+	continue;
+      if( us >= 0.07 && v <= vr )
+	return (unsigned long) k;
+      if( log(v * alpha / (a / (us * us) + b))
+	  <= h - rand55_logfact(k) - rand55_logfact(n - k) + (k - m) * lpq )
+	return (unsigned long) k;
+    }
+  }
+}
+
 /* Knuth II, S. 172 */
 unsigned long init_rand55 ( unsigned long seed55 )
 {
-  long j, k, i, ii ;
+  return init_rand55_r( &rand55_g, seed55 );
+}
 
+#ifndef RAND55_PHILOX
+/*
+  the state warmed up last by this thread, a reinitialisation with the
+  same seed, e.g. by reinit() in Sage, copies it instead of running the
+  warm-up again
+*/
+static __thread unsigned long rand55_warm_seed ;   /* 0: none */
+static __thread rand55_state  rand55_warm ;
 
-  rand55_k=rand55_0k;
-  rand55_j=rand55_0j;
-  memcpy(rand55_s,rand55_0s, sizeof(rand55_s));
+/* fill the state from a 64 bit hash (splitmix64) of the seed */
+static void rand55_hash_fill ( rand55_state *st, unsigned long seed55 )
+{
+  unsigned long z = seed55 ;
+  int i ;
 
-  if(seed55==0)
+  for ( i = 0 ; i < rand55_K ; i++ ) {
+    z += 0x9E3779B97F4A7C15UL ;
+    st->s[i] = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9UL ;
+    st->s[i] = ( st->s[i] ^ ( st->s[i] >> 27 ) ) * 0x94D049BB133111EBUL ;
+    st->s[i] ^= st->s[i] >> 31 ;
+  }
+  st->s[0] |= 1 ;   /* the period needs an odd element */
+  st->j = rand55_J ;
+  st->k = rand55_K ;
+#if RAND55_BLOCK
+  st->left = st->filled = 0 ;
+#endif
+  /* the hashed words are independent already, a few rounds of the
+     recurrence mix the lags */
+  for ( i = 20 * rand55_K ; i ; i-- )
+    rand55_r(st) ;
+}
+#endif
+
+static unsigned long rand55_clock_seed ( void )
+{
 #ifdef __TURBOC__
-    {
-      extern unsigned long clock(void);
-      seed55=clock() | 1;
-    }
+  extern unsigned long clock(void);
+  return clock() | 1;
 #else
-  {
-    seed55=time(NULL) | 1;
-  }
+  return time(NULL) | 1;
 #endif
+}
+
+unsigned long init_rand55_hash_r ( rand55_state *st, unsigned long seed55 )
+{
+  if ( seed55 == 0 )
+    seed55 = rand55_clock_seed() ;
+#ifdef RAND55_PHILOX
+  /* the key is the seed, no warm-up needed */
+  st->key[0] = seed55 ;
+  st->key[1] = 0 ;
+  rand55_seek_r( st, 0, 0, 0 ) ;
+#else
+  rand55_hash_fill( st, seed55 ) ;
+#endif
+  return seed55 ;
+}
+
+int rand55_save ( const rand55_state *st, FILE *f )
+{
+  return fwrite( st, sizeof(rand55_state), 1, f ) == 1 ? 0 : -1 ;
+}
+
+int rand55_load ( rand55_state *st, FILE *f )
+{
+  return fread( st, sizeof(rand55_state), 1, f ) == 1 ? 0 : -1 ;
+}
+
+unsigned long init_rand55_r ( rand55_state *st, unsigned long seed55 )
+{
+#if defined(RAND55_HASH_INIT) || defined(RAND55_PHILOX)
+  return init_rand55_hash_r( st, seed55 ) ;
+#else
+  long j, k, i, ii ;
+
+
+  memcpy(st->s,rand55_0s, sizeof(st->s));
+
+  if(seed55==0)
+    seed55=rand55_clock_seed();
 
   if(seed55<100000L)
     {
       fprintf(stderr,"init_rand55: WARNING seed55=%lu is small\n",seed55);
       seed55=9999999L;
     }
+
+  if(seed55==rand55_warm_seed)
+    {
+      *st = rand55_warm ;
+      return seed55;
+    }
   /*
     rand55 initialisieren
   */
-  rand55_s[ rand55_K - 1 ] = j = seed55 ;
+  st->s[ rand55_K - 1 ] = j = seed55 ;
   k = 1 ;
   for ( i = 0 ; i < ( rand55_K - 1 ) ; i++ )  {
     ii      = ( 21 * i ) % rand55_K ;
-    rand55_s[ii] = k ;
+    st->s[ii] = k ;
     k       = j - k ;
-    j       = rand55_s[ii] ;
+    j       = st->s[ii] ;
   }
 
   /*
     Warmlaufen
   */
-  rand55_j = rand55_J ;
-  rand55_k = rand55_K ;
+  st->j = rand55_J ;
+  st->k = rand55_K ;
+#if RAND55_BLOCK
+  st->left = st->filled = 0 ;
+#endif
   for ( i = 10000000L ; i ; i-- )
-    rand55() ;
+    rand55_r(st) ;
+
+  rand55_warm      = *st ;
+  rand55_warm_seed = seed55 ;
 
   return seed55;
+#endif
+}
+
+#ifdef RAND55_PHILOX
+/* Philox4x64: ten rounds of two 64x64->128 bit products, key bumps */
+void philox_rand55 ( const rand55_t key[2], const rand55_t ctr[4],
+                     rand55_t out[4] )
+{
+  rand55_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3] ;
+  rand55_t k0 = key[0], k1 = key[1] ;
+  int r ;
+
+  for ( r = 0 ; r < 10 ; r++ ) {
+    unsigned __int128 p0 = (unsigned __int128) 0xD2E7470EE14C6C93UL * c0 ;
+    unsigned __int128 p1 = (unsigned __int128) 0xCA5A826395121157UL * c2 ;
+
+    c0 = (rand55_t)( p1 >> 64 ) ^ c1 ^ k0 ;
+    c1 = (rand55_t) p1 ;
+    c2 = (rand55_t)( p0 >> 64 ) ^ c3 ^ k1 ;
+    c3 = (rand55_t) p0 ;
+    k0 += 0x9E3779B97F4A7C15UL ;
+    k1 += 0xBB67AE8584CAA73BUL ;
+  }
+  out[0] = c0 ; out[1] = c1 ; out[2] = c2 ; out[3] = c3 ;
 }
 
-#define NOELSE (-1)
+/* after a seek the buffer is filled with 4, 8, 16, ... numbers, so the
+   stream of a cell that draws a few numbers only does not pay for a whole
+   block; the numbers go to the end of buf */
+void rand55_refill ( rand55_state *st )
+{
+  int i, n ;
+
+  n = st->ctr[0] < RAND55_BLOCK / 4 ? 4 * (int) ( st->ctr[0] + 1 )
+                                    : RAND55_BLOCK ;
+  for ( i = RAND55_BLOCK - n ; i < RAND55_BLOCK ; i += 4, st->ctr[0]++ )
+    philox_rand55( st->key, st->ctr, st->buf + i ) ;
+  st->left = n ;
+}
+
+void rand55_seek_r ( rand55_state *st, rand55_t replica, rand55_t cell,
+                     rand55_t step )
+{
+  st->ctr[0] = 0 ;
+  st->ctr[1] = step ;
+  st->ctr[2] = cell ;
+  st->ctr[3] = replica ;
+  st->left   = 0 ;
+}
+#elif RAND55_BLOCK
+void rand55_refill ( rand55_state *st )
+{
+  rand55_t *x = st->buf ;
+  int i, l, m ;
 
+  if ( !st->filled )
+    /* s[k+m] has been written m steps ago, k == 55 is k == 0 */
+    for ( m = 0 ; m < rand55_K ; m++ )
+      x[ rand55_K - 1 - m ] = st->s[ ( st->k + m ) % rand55_K ] ;
+  else
+    memmove( x, x + RAND55_BLOCK, rand55_K * sizeof(rand55_t) ) ;
+
+  /* x[i+l-24] lies before the chunk of 24, so the inner loop has no
+     dependency and a fixed trip count, it is vectorised even at -O2 */
+  for ( i = rand55_K ; i + rand55_J <= rand55_K + RAND55_BLOCK ; i += rand55_J )
+    for ( l = 0 ; l < rand55_J ; l++ )
+      x[ i + l ] = x[ i + l - rand55_K ] + x[ i + l - rand55_J ] ;
+  for ( ; i < rand55_K + RAND55_BLOCK ; i++ )
+    x[i] = x[ i - rand55_K ] + x[ i - rand55_J ] ;
+  st->left   = RAND55_BLOCK ;
+  st->filled = 1 ;
+}
+#endif
+
+unsigned long rand55_stream_seed ( unsigned long seed, unsigned long stream )
+{
+  /* splitmix64 finalizer, decorrelates neighbouring stream numbers */
+  unsigned long z = seed + (stream+1) * 0x9E3779B97F4A7C15UL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+  z ^= z >> 31;
+  return z | 0x100000000UL;   /* init_rand55 rejects small seeds */
+}
+
+unsigned long init_rand55_stream ( rand55_state *st, unsigned long seed,
+                                   unsigned long stream )
+{
+  return init_rand55_r( st, rand55_stream_seed( seed, stream ) );
+}
+
+/*	Vose's linear set up of Walker's alias tables: small entries,
+*	aliasprob < 1, are paired in index order with the next large one,
+*	which gives away what fills the small one up to 1. A large entry
+*	that drops below 1 behind the small scanner is paired at once,
+*	one ahead of it is found by the scanner later. So the tables need
+*	no work lists, and any nalias will do.
+*/
 void init_alias55(double *prob, double *aliasprob, int *aliaselse, const int nalias)
 {
-  int i, j;
-  int	maxi, mini;
-  double	maxprob, minprob;
+  int i, j, s, l;
+  double sum = 0;
 
-  for( j = 0 ; j < nalias  ; j ++ ) {
-    aliaselse[j] = NOELSE;
-    aliasprob[j] = prob[j];
+  for( i = 0 ; i < nalias ; i++ )
+    sum += prob[i];
+  for( i = 0 ; i < nalias ; i++ ) {
+    aliaselse[i] = i;
+    aliasprob[i] = prob[i] * nalias / sum;
   }
 
-  for( j = nalias ; j  ; j -- ) {
-    maxprob	=	-1.0;
-    minprob =	 2.0;
-    /*	determine max and min of not
-     *	yet deleted pairs
-     */
-    for( i = 0 ; i < nalias ; i++) {
-      if( aliaselse[i] == NOELSE )  {
-	if( aliasprob[i] > maxprob ) {
-	  maxprob = aliasprob[i];
-	  maxi = i;
-	}
-
-	if( aliasprob[i] < minprob ) {
-	  minprob = aliasprob[i];
-	  mini = i;
-	}
+  for( l = 0 ; l < nalias && aliasprob[l] < 1.0 ; l++ );
+  for( i = 0 ; i < nalias && aliasprob[i] >= 1.0 ; i++ );
+  s = i++;   /* the small entry to pair, i scans on */
+
+  while( s < nalias && l < nalias ) {
+    aliaselse[s]  = l;
+    aliasprob[l] -= 1.0 - aliasprob[s];
+    if( aliasprob[l] < 1.0 ) {
+      j = l;
+      for( l++ ; l < nalias && aliasprob[l] < 1.0 ; l++ );
+      if( j < i ) {
+	s = j;
+	continue;
       }
     }
-    /*	compute probability of jumping to
-     *	aliaselse
-     */
-    aliaselse[mini]	=  maxi;
-    aliasprob[maxi]	+=
-      aliasprob[mini] - 1.0/nalias;
-    aliasprob[mini] *= nalias;
-#ifdef TESTXXX
-    for( i = 0 ; i < nalias ; i++)
-      printf("# %2d->%2d a=%lf p=%lf\n",
-	     i, aliaselse[i], aliasprob[i],prob[i]);
-    getch();
-#endif
+    for( ; i < nalias && aliasprob[i] >= 1.0 ; i++ );
+    s = i++;
   }
 
+  /* what is left is 1 up to rounding */
+  for( j = 0 ; j < nalias ; j++ )
+    if( aliaselse[j] == j )
+      aliasprob[j] = 1.0;
 }
-#undef NOELSE
 #undef N_GAUSS
 #undef N_GAUSSHALF
 
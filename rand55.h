@@ -61,6 +61,17 @@
 *                    random number in the range 0..MAX_ULONG. The direct
 *                    way!
 *
+*    init_rand55_r(st,seed), rand55_r(st), drand55_r(st), lrand55_r(st,l),
+*    exp_rand55_r(st), gauss_rand55_r(st), alias_rand55_r(st,...):
+*                    the same on a private generator state st of type
+*                    rand55_state, for running several simulations in
+*                    one process. The draws are inline functions.
+*
+*    init_rand55_stream(st,seed,stream):
+*                    seeds st with stream number stream derived from the
+*                    master seed, see rand55_stream_seed. Every thread or
+*                    replica takes its own stream number.
+*
 *    The Alias-Method by A. J. Walker
 *
 *     init_alias55(double *prob, double *aliasprob, 
@@ -73,8 +84,9 @@
 *                    alias-method to accept i directly.
 *                    The aliaselse array is set up to the alias to generate
 *                    if i is not accepted. The possible range of i 
-*        !!!            is 0..nalias-1,    where nalias MUST BE A POWER OF 2,
-*                    else you have to fill up your array by 0s!
+*                    is 0..nalias-1, prob need not be normalized. The set
+*                    up takes O(nalias) and allocates nothing, tables may
+*                    be rebuilt whenever the rates change.
 *                    
 *    alias_rand55(aliasprob, aliaselse, nalias) :
 *                    macro, whose inputs are the arrays aliasprob and aliaselse
@@ -82,6 +94,11 @@
 *                    It generates long integer random numbers according the
 *                    probability distribution prob you have called with 
 *                    the procedure init_alias55().
+*        !!!         nalias MUST BE A POWER OF 2, else use
+*
+*    alias_n_rand55(aliasprob, aliaselse, nalias) :
+*                    the same for any nalias, by a multiplication instead
+*                    of the mask and with one draw only.
 *
 *    Some important distributions: 
 *
@@ -94,10 +111,23 @@
 *                    generate gaussian distributed random numbers with
 
 *                    mean 0 and standard deviation 1.
+*
+*    poisson_rand55(mu), binomial_rand55(n,p):
+*                    functions, Poisson distributed unsigned longs of mean
+*                    mu and the number of successes in n trials of
+*                    probability p. Inversion for means below 10, else the
+*                    transformed rejection of Hoermann (PTRS, BTRS), which
+*                    costs a few draws whatever the mean.
+*
+*    exp_zig_rand55_r(st), gauss_zig_rand55_r(st):
+*                    the same by the ziggurat method, which
+*                    exp_rand55 and gauss_rand55 use if compiled with
+*                    -DRAND55_ZIGGURAT.
 */
 #ifndef _RAND55_H
 #define _RAND55_H 
 #include <math.h>
+#include <stdio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -123,38 +153,226 @@ typedef unsigned long rand55_t;
 #define rand55_K 55
 #define rand55_J 24
 
-#define rand55() ( (rand55_k)?(rand55_k)--:((rand55_k)=54),(rand55_j)?(rand55_j)--:((rand55_j)=54),rand55_s[(rand55_k)]=rand55_s[(rand55_k)]+rand55_s[(rand55_j)])
+/*
+** rand55_r hands out numbers from a buffer of RAND55_BLOCK numbers, which
+** rand55_refill generates in one go by x[n] = x[n-55] + x[n-24]; as the
+** shorter lag is 24, chunks of 24 numbers do not depend on each other
+** and the loop is vectorised. The sequence is the same as drawing one by
+** one. -DRAND55_BLOCK=0 draws one by one directly from s, j, k.
+**
+** With the buffer, s, j and k hold the state before the first refill
+** only, e.g. after init_rand55_r or in the static rand55_g; afterwards
+** the last 55 numbers at the beginning of buf are the state.
+*/
+#ifndef RAND55_BLOCK
+#define RAND55_BLOCK 1024
+#endif
+
+#ifdef RAND55_PHILOX
+/*
+** -DRAND55_PHILOX replaces the lagged Fibonacci generator behind the same
+** interface by the counter based Philox4x64-10 (Salmon et al., Parallel
+** random numbers: as easy as 1, 2, 3, SC 2011). Number i of a stream is a
+** bijection of the counter (i/4, step, cell, replica) under the key, the
+** seed; there is no state to carry over, so a draw depends on
+** (seed, replica, cell, step, i) only and not on which thread or in which
+** order the cells were handled. rand55_seek_r selects the stream, the
+** sweeps of leap.c and nsm_start do so per cell, see sm_sweep in
+** randomwalk.h. The buffer holds up to RAND55_BLOCK numbers generated in
+** one go, fewer right after a seek.
+*/
+#if !RAND55_BLOCK || RAND55_BLOCK % 4
+#error "RAND55_PHILOX needs RAND55_BLOCK a multiple of 4"
+#endif
+typedef struct RAND55_STATE{
+  rand55_t key[2];                     /* seed, 0                        */
+  rand55_t ctr[4];                     /* next block, step, cell, replica */
+  unsigned left;                       /* numbers left in buf            */
+  rand55_t buf[RAND55_BLOCK];
+} rand55_state;
+
+void rand55_refill(rand55_state *st);
+void rand55_seek_r(rand55_state *st, rand55_t replica, rand55_t cell,
+                   rand55_t step);
+void philox_rand55(const rand55_t key[2], const rand55_t ctr[4],
+                   rand55_t out[4]);
+
+static inline rand55_t rand55_r(rand55_state *st){
+  if(__builtin_expect(!st->left, 0))
+    rand55_refill(st);
+  return st->buf[RAND55_BLOCK-st->left--];
+}
+#else
+/* --> Knuth, Art of Computer-Programming, Vol. 2, p. 172 */
+typedef struct RAND55_STATE{
+  rand55_t s[rand55_K];
+  short    j, k;
+#if RAND55_BLOCK
+  unsigned left;                       /* numbers left in buf            */
+  short    filled;                     /* 0: buf holds no history yet    */
+  rand55_t buf[rand55_K+RAND55_BLOCK]; /* 55 numbers of history, block   */
+#endif
+} rand55_state;
+
+#if RAND55_BLOCK
+void rand55_refill(rand55_state *st);
+#endif
+
+/*
+** The _r variants draw from the generator state st, so every simulation
+** may own its stream.  The classical macros draw from the process-wide
+** state rand55_g and produce exactly the same sequence as before.
+*/
+static inline rand55_t rand55_r(rand55_state *st){
+#if RAND55_BLOCK
+  if(__builtin_expect(!st->left, 0))
+    rand55_refill(st);
+  return st->buf[rand55_K+RAND55_BLOCK-st->left--];
+#else
+  if(st->k) st->k--; else st->k=54;
+  if(st->j) st->j--; else st->j=54;
+  return st->s[st->k]+=st->s[st->j];
+#endif
+}
+#endif /* RAND55_PHILOX */
+
+#ifdef __TURBOC__
+static inline double drand55_r(rand55_state *st){
+  return ldexp((double)(rand55_r(st)>>1),1-rand55_modpwr);
+}
+#else
+static inline double drand55_r(rand55_state *st){
+  return ldexp((double)(rand55_r(st)),-rand55_modpwr);
+}
+#endif
+
+static inline rand55_t lrand55_r(rand55_state *st, rand55_t l){
+  return (rand55_r(st)>>1)%l;
+}
 
 #ifdef NONDP
 #error "randmin not implemented"
 #define exp_rand55 rand_min
 #else
-#define exp_rand55() ( - log( 1.0 - drand55() ) )
+static inline double exp_log_rand55_r(rand55_state *st){
+  return - log( 1.0 - drand55_r(st) );
+}
 #endif
 
-#ifdef __TURBOC__
-#define drand55() ldexp((double)(rand55()>>1),1-rand55_modpwr)
+/*
+** Ziggurat samplers (Marsaglia, Tsang 2000): the top bits of one draw
+** pick a layer, the low 56 bits a point in it, which is accepted in
+** about 99% of the cases without a log or exp. The tables are written by
+** createziggurat.c into ziggurat55static.c. -DRAND55_ZIGGURAT makes
+** exp_rand55 and gauss_rand55 use them; the sequences differ from those
+** of the log and the alias versions.
+*/
+#define rand55_Z56 ((((rand55_t)1)<<56)-1)
+extern const double   rand55_zexp_r, rand55_zgauss_r;
+extern const rand55_t rand55_zexp_k[256], rand55_zgauss_k[128];
+extern const double   rand55_zexp_w[256], rand55_zgauss_w[128];
+extern const double   rand55_zexp_f[257], rand55_zgauss_f[129];
+double exp_zig_rand55_wedge(rand55_state *st, rand55_t u);
+double gauss_zig_rand55_wedge(rand55_state *st, rand55_t u);
+
+static inline double exp_zig_rand55_r(rand55_state *st){
+  rand55_t u = rand55_r(st), j = u & rand55_Z56;
+  int i = (int)(u >> 56);
+  if(__builtin_expect(j < rand55_zexp_k[i], 1))
+    return j * rand55_zexp_w[i];
+  return exp_zig_rand55_wedge(st, u);
+}
+
+static inline double gauss_zig_rand55_r(rand55_state *st){
+  rand55_t u = rand55_r(st), j = u & rand55_Z56;
+  int i = (int)(u >> 57);
+  if(__builtin_expect(j < rand55_zgauss_k[i], 1))
+    return j * rand55_zgauss_w[i] * (1.0 - (double)(u >> 55 & 2));
+  return gauss_zig_rand55_wedge(st, u);
+}
+
+#ifdef RAND55_ZIGGURAT
+#define exp_rand55_r exp_zig_rand55_r
 #else
-#define drand55() ldexp((double)(rand55()),-rand55_modpwr)
+#define exp_rand55_r exp_log_rand55_r
 #endif
 
-#define lrand55(l) ((rand55()>>1)%(l))
+#define rand55()     rand55_r(&rand55_g)
+#define drand55()    drand55_r(&rand55_g)
+#define lrand55(l)   lrand55_r(&rand55_g,(l))
+#define exp_rand55() exp_rand55_r(&rand55_g)
 
 unsigned long init_rand55(unsigned long);
+unsigned long init_rand55_r(rand55_state *st, unsigned long);
+
+/*
+** Independent streams from one master seed: the seed of stream number
+** stream is a 64 bit hash (splitmix64) of both, so neighbouring stream
+** numbers give unrelated states. The period of rand55 is at least 2^55,
+** the chance that two of a few thousand streams overlap within 2^40
+** draws is negligible. The same seed and stream give the same sequence,
+** whatever thread draws it.
+*/
+unsigned long rand55_stream_seed(unsigned long seed, unsigned long stream);
+
+/*
+** Startup: init_rand55_r runs the recurrence 10^7 times after seeding,
+** about 15 ms. The state warmed up last is remembered per thread, so
+** seeding again with the same seed is a copy.
+** init_rand55_hash_r fills the state from a 64 bit hash of the seed and
+** runs 1100 steps only, a few microseconds; its sequences differ from
+** those of init_rand55_r. create_walk_seeded and the seeding of an
+** ensemble select it at run time, see sagemarkov.h; -DRAND55_HASH_INIT
+** makes init_rand55_r, and so every walk, seed this way.
+** A state is plain data, rand55_save and rand55_load write and read it
+** binary, for the same build; return 0 or -1.
+*/
+unsigned long init_rand55_hash_r(rand55_state *st, unsigned long seed);
+int rand55_save(const rand55_state *st, FILE *f);
+int rand55_load(rand55_state *st, FILE *f);
+unsigned long init_rand55_stream(rand55_state *st, unsigned long seed,
+                                 unsigned long stream);
 
 extern unsigned long int rand55_sel;
-extern short     rand55_j,rand55_0j;
-extern short     rand55_k,rand55_0k; 
-/* --> Knuth, Art of Computer-Programming, Vol. 2, p. 172 */
-extern rand55_t rand55_s[rand55_K],rand55_0s[rand55_K];
+extern rand55_state rand55_g;
+extern rand55_t rand55_0s[rand55_K];
 
 extern long     rand55_alias;
-#define alias_rand55(aliasprob, aliaselse, nalias) ( aliasprob[  _alias55 = ( rand55()&(nalias-1) )  ] > drand55()  ? _alias55 : aliaselse[_alias55] )
+static inline long alias_rand55_r(rand55_state *st, const double *aliasprob,
+                                  const int *aliaselse, int nalias){
+  long a = rand55_r(st)&(nalias-1);
+  return aliasprob[a] > drand55_r(st) ? a : aliaselse[a];
+}
+#define alias_rand55(aliasprob, aliaselse, nalias) alias_rand55_r(&rand55_g,(aliasprob),(aliaselse),(nalias))
+
+/*
+** any nalias: the high half of rand55()*nalias is the entry, the low half
+** the uniform to accept it, one draw and no division
+*/
+static inline long alias_n_rand55_r(rand55_state *st, const double *aliasprob,
+                                    const int *aliaselse, int nalias){
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 m = (unsigned __int128)rand55_r(st) * (rand55_t)nalias;
+  long a = (long)(m >> 64);
+  return aliasprob[a] > ldexp((double)(rand55_t)m, -64) ? a : aliaselse[a];
+#else
+  long a = lrand55_r(st, nalias);
+  return aliasprob[a] > drand55_r(st) ? a : aliaselse[a];
+#endif
+}
+#define alias_n_rand55(aliasprob, aliaselse, nalias) alias_n_rand55_r(&rand55_g,(aliasprob),(aliaselse),(nalias))
 
 void     init_alias55(double *prob, double *aliasprob,
                         int *aliaselse, const int nalias);
 
 double gauss_rand55(void);
+double gauss_rand55_r(rand55_state *st);
+double gauss_alias_rand55_r(rand55_state *st);
+
+unsigned long poisson_rand55_r(rand55_state *st, double mu);
+unsigned long binomial_rand55_r(rand55_state *st, unsigned long n, double p);
+#define poisson_rand55(mu)     poisson_rand55_r(&rand55_g,(mu))
+#define binomial_rand55(n,p)   binomial_rand55_r(&rand55_g,(n),(p))
 
 
 #ifdef __cplusplus
@@ -17,11 +17,11 @@
 #include "rand55.h"
 #include "gauss55.h"
 
-short rand55_0j,rand55_j = 34;
-
-short rand55_0k,rand55_k = 10;
-
-unsigned long rand55_s[rand55_K]={8616912670363561253UL,
+/* designated, the buffer fields start empty */
+#ifdef RAND55_PHILOX
+rand55_state rand55_g={.key={9999999UL}};
+#else
+rand55_state rand55_g={.s={8616912670363561253UL,
 	16897454438490524172UL,
 	13812272661439093232UL,
 	18109984949696772680UL,
@@ -75,7 +75,10 @@ unsigned long rand55_s[rand55_K]={8616912670363561253UL,
 	13911173504294467787UL,
 	1205672696364013313UL,
 	8138266784556628917UL,
-	14380057553953602560UL};
+	14380057553953602560UL},
+	.j=34,
+	.k=10};
+#endif
 
 unsigned long rand55_0s[rand55_K]={8616912670363561253UL,
 	16897454438490524172UL,
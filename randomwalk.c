@@ -16,28 +16,43 @@
 */
 
 #include <randomwalk.h>
+#include <recorder.h>
+#include <moments.h>
 
-double markov_step(){
-    LC_DRAW(cell,source);
+double markov_step(sm_context *ctx){
+    LC_DRAW_IN(&ctx->lc,cell,source);
     
-    double time_step=LC_TIME_STEP();
+    double time_step=LC_TIME_STEP_IN(&ctx->lc);
+
+    if( ctx->markov_time+time_step > ctx->record_at )
+      recorder_sample(ctx, ctx->markov_time+time_step);
 
     lc_reactivity_t reaction  = reaction_reactivity(source);
     lc_reactivity_t diffusion = diffusion_reactivity(source);
 
-    if( drand55()* ( reaction + diffusion ) < reaction ){
+    unsigned long before[SM_SPECIES];
+    if( ctx->moments )
+      moments_before(source, before);
+
+    if( lc_t_rand(&ctx->rng, reaction + diffusion) < reaction ){
        // reaction step
       reaction_step(source);
+      if( ctx->moments )
+        moments_step(ctx, source, source, before);
 
-      LC_UPDATE_DRAWN(source);
+      LC_UPDATE_DRAWN_IN(&ctx->lc,source);
 
     } else {
       // diffusion step
-      cell * dest = diffusion_step(source);
-      
-      LC_UPDATE_DRAWN(source);
-
-      LC_UPDATE(dest);
+      cell * dest = diffusion_step(ctx,source);
+      if( ctx->moments )
+        moments_step(ctx, source, dest, before);
+      void * ueds[2] = { source, dest };
+      lc_reactivity_t r[2] = { (lc_reactivity_t)LC_REACTIVITY(source),
+                               (lc_reactivity_t)LC_REACTIVITY(dest) };
+
+      // one total reactivity update, reorganisation only after both moved
+      lc_update_batch(&ctx->lc, ueds, r, 2);
 
     }
     return time_step;
@@ -19,10 +19,73 @@
 #define __RANDOMWALK_H___
 
 #include <logclass.h>
+#include <topology.h>
+
+/*
+** everything one simulation owns: the lattice of cells, the logclass
+** structure and its own random stream. lc.rng points to rng, so a
+** context must not be copied by value once create_walk has run.
+** The topology is only referenced and may be shared by several contexts.
+** With nsm set, the cells are stepped by nsm_step instead of markov_step.
+** With recorder set, both call recorder_sample before firing an event
+** that passes record_at, see recorder.h. With moments set, both keep
+** them up to date, see moments.h.
+*/
+typedef struct SM_CONTEXT{
+  lc_global lc;
+  rand55_state rng;
+  const sm_topology *topology;
+  cell * cells;
+  size_t number_of_cells;
+  double markov_time, timescale;
+  unsigned long seed;
+  struct SM_NSM *nsm;           /* next-subvolume engine, NULL: logclass */
+  struct SM_RECORDER *recorder; /* time sampled observables, NULL: none  */
+  double record_at;             /* its next sample time, else INFINITY   */
+  struct SM_MOMENTS *moments;   /* walker totals and moments, NULL: none */
+} sm_context;
+
+/*
+** The random numbers of cell i in a sweep over all cells, a leap, a
+** diffusion split or scheduling every cell. Under RAND55_PHILOX they come
+** from stream (0, i, step) of the seed of ctx->rng, step drawn from
+** ctx->rng once per sweep by sweep_start, so they do not depend on the
+** order the cells are handled in. Otherwise they come from ctx->rng
+** itself, in cell order.
+*/
+typedef struct SM_SWEEP{
+  rand55_state *rng;
+#ifdef RAND55_PHILOX
+  rand55_t step;
+  rand55_state cell;
+#endif
+} sm_sweep;
+
+static inline void sweep_start(sm_context *ctx, sm_sweep *s){
+  s->rng=&ctx->rng;
+#ifdef RAND55_PHILOX
+  s->step=rand55_r(&ctx->rng);
+  s->cell.key[0]=ctx->rng.key[0];
+  s->cell.key[1]=ctx->rng.key[1];
+#endif
+}
+
+static inline rand55_state *sweep_cell(sm_sweep *s, size_t i){
+#ifdef RAND55_PHILOX
+  rand55_seek_r(&s->cell, 0, i, s->step);
+  return &s->cell;
+#else
+  (void) i;
+  return s->rng;
+#endif
+}
 
 lc_reactivity_t reaction_reactivity(const cell *);
 lc_reactivity_t diffusion_reactivity(const cell *);
-cell * diffusion_step(cell *);
+cell * diffusion_step(sm_context *ctx, cell *);
+
+cell * random_neighbour(sm_context *ctx, cell * source);
+cell * neighbour(const sm_context *ctx, cell * source, size_t neighbour);
 
-double markov_step();
+double markov_step(sm_context *ctx);
 #endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Time sampled observables, see recorder.h.
+
+  ctx->record_at holds the next sample time, INFINITY without a recorder,
+  the steppers compare it with the time of the event drawn and call
+  recorder_sample only when a sample time is passed. All sample times of
+  one call see the same state, it is evaluated once and copied.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <recorder.h>
+#include <moments.h>
+
+int recorder_create(sm_recorder *rec, double start, double interval, size_t capacity){
+  memset(rec, 0, sizeof(*rec));
+  if(!(interval > 0) || !capacity)
+    return -1;
+  rec->start    = start;
+  rec->interval = interval;
+  rec->capacity = capacity;
+  return 0;
+}
+
+int recorder_create_times(sm_recorder *rec, const double *times, size_t number_of_times){
+  memset(rec, 0, sizeof(*rec));
+  if(!times || !number_of_times)
+    return -1;
+  for(size_t k=1; k<number_of_times; k++)
+    if(!(times[k-1] <= times[k]))
+      return -1;
+  rec->times    = times;
+  rec->capacity = number_of_times;
+  return 0;
+}
+
+/* sample time k, INFINITY past the end of a list */
+static double recorder_at(const sm_recorder *rec, size_t k){
+  if(rec->times)
+    return k < rec->capacity ? rec->times[k] : INFINITY;
+  return rec->start+k*rec->interval;
+}
+
+void recorder_destroy(sm_recorder *rec){
+  for(size_t o=0; o<rec->number_of_observables; o++){
+    free(rec->observables[o].lo);
+    free(rec->observables[o].hi);
+  }
+  free(rec->observables);
+  free(rec->ring);
+  memset(rec, 0, sizeof(*rec));
+}
+
+static sm_record *recorder_add(sm_recorder *rec, int kind){
+  sm_record *o;
+
+  if(rec->ring)
+    return NULL;                /* attached already */
+  o=realloc(rec->observables, (rec->number_of_observables+1)*sizeof(sm_record));
+  if(!o)
+    return NULL;
+  rec->observables=o;
+  o+=rec->number_of_observables++;
+  memset(o, 0, sizeof(*o));
+  o->kind=kind;
+  return o;
+}
+
+int recorder_reactivity(sm_recorder *rec){
+  return recorder_add(rec, SM_RECORD_REACTIVITY) ? (int) rec->number_of_observables-1 : -1;
+}
+
+int recorder_walkers(sm_recorder *rec){
+  return recorder_add(rec, SM_RECORD_WALKERS) ? (int) rec->number_of_observables-1 : -1;
+}
+
+int recorder_function(sm_recorder *rec, sm_observable f){
+  sm_record *o;
+
+  if(!f || !(o=recorder_add(rec, SM_RECORD_FUNCTION)))
+    return -1;
+  o->f=f;
+  return (int) rec->number_of_observables-1;
+}
+
+int recorder_region(sm_recorder *rec, const sm_topology *topology,
+                    const size_t *lo, const size_t *hi){
+  const int dim=topology->dimension;
+  size_t *l, *h;
+  sm_record *o;
+
+  for(int d=0; d<dim; d++)
+    if(lo[d] >= hi[d] || hi[d] > topology->sizes[d+1]/topology->sizes[d])
+      return -1;
+  l=malloc(dim*sizeof(size_t));
+  h=malloc(dim*sizeof(size_t));
+  if(!l || !h || !(o=recorder_add(rec, SM_RECORD_REGION))){
+    free(l);
+    free(h);
+    return -1;
+  }
+  memcpy(l, lo, dim*sizeof(size_t));
+  memcpy(h, hi, dim*sizeof(size_t));
+  o->lo=l;
+  o->hi=h;
+  return (int) rec->number_of_observables-1;
+}
+
+int recorder_attach(sm_context *ctx, sm_recorder *rec){
+  double k;
+
+  if(!rec->ring){
+    rec->ring=malloc(rec->capacity*(rec->number_of_observables ? rec->number_of_observables : 1)
+                     *sizeof(double));
+    if(!rec->ring)
+      return -1;
+  }
+  if(rec->times)
+    while(recorder_at(rec, rec->sampled) < ctx->markov_time)
+      rec->sampled++;
+  else{
+    k=ceil((ctx->markov_time-rec->start)/rec->interval);
+    if(k > (double) rec->sampled)
+      rec->sampled=(size_t) k;
+  }
+  ctx->recorder=rec;
+  ctx->record_at=recorder_at(rec, rec->sampled);
+  return 0;
+}
+
+void recorder_detach(sm_context *ctx){
+  ctx->recorder=NULL;
+  ctx->record_at=INFINITY;
+}
+
+/* walkers in the box of o, by an odometer over its coordinates */
+static double recorder_box(const sm_context *ctx, const sm_record *o){
+  const sm_topology *t=ctx->topology;
+  const int dim=t->dimension;
+  size_t x[dim], index=0;
+  double sum=0;
+  int d;
+
+  for(d=0; d<dim; d++){
+    x[d]=o->lo[d];
+    index+=x[d]*t->sizes[d];
+  }
+  for(;;){
+    for(size_t i=o->lo[0]; i<o->hi[0]; i++)
+      sum+=population(ctx->cells+index+i-o->lo[0]);
+    for(d=1; d<dim; d++){
+      if(++x[d] < o->hi[d]){
+        index+=t->sizes[d];
+        break;
+      }
+      index-=(x[d]-1-o->lo[d])*t->sizes[d];
+      x[d]=o->lo[d];
+    }
+    if(d == dim)
+      return sum;
+  }
+}
+
+/* the kept total if there is one */
+static double recorder_walkers_all(sm_context *ctx){
+  double sum=0;
+
+  if(ctx->moments)
+    return (double) walk_moments(ctx)->walkers;
+  for(size_t i=0; i<ctx->number_of_cells; i++)
+    sum+=population(ctx->cells+i);
+  return sum;
+}
+
+static double recorder_value(sm_context *ctx, const sm_record *o){
+  switch(o->kind){
+  case SM_RECORD_REACTIVITY:
+    return (double) global_reactivity(ctx);
+  case SM_RECORD_WALKERS:
+    return recorder_walkers_all(ctx);
+  case SM_RECORD_REGION:
+    return recorder_box(ctx, o);
+  default:
+    return o->f(ctx);
+  }
+}
+
+void recorder_sample(sm_context *ctx, double time){
+  sm_recorder *rec=ctx->recorder;
+  const size_t no=rec ? rec->number_of_observables : 0;
+  double *row, *state=NULL;
+  double at;
+
+  if(!rec){
+    ctx->record_at=INFINITY;
+    return;
+  }
+  for(at=recorder_at(rec, rec->sampled); at < time;
+      at=recorder_at(rec, ++rec->sampled)){
+    if(rec->rows < rec->capacity)
+      row=rec->ring+(rec->first+rec->rows++)%rec->capacity*no;
+    else{
+      row=rec->ring+rec->first*no;
+      rec->first=(rec->first+1)%rec->capacity;
+    }
+
+    if(at < ctx->markov_time){
+      /* passed without sampling, e.g. by leaping */
+      for(size_t o=0; o<no; o++)
+        row[o]=NAN;
+      rec->missed++;
+    }
+    else if(state){
+      if(row != state)
+        memcpy(row, state, no*sizeof(double));
+    }
+    else{
+      for(size_t o=0; o<no; o++)
+        row[o]=recorder_value(ctx, rec->observables+o);
+      state=row;
+    }
+  }
+  ctx->record_at=at;
+}
+
+/* reverses the doubles a[0..n) */
+static void recorder_reverse(double *a, size_t n){
+  for(size_t i=0, j=n; i+1 < j; i++, j--){
+    double x=a[i];
+    a[i]=a[j-1];
+    a[j-1]=x;
+  }
+}
+
+const double *recorder_data(sm_recorder *rec){
+  const size_t no=rec->number_of_observables;
+
+  if(rec->first){
+    /* full ring, rotated left by first rows */
+    recorder_reverse(rec->ring, rec->first*no);
+    recorder_reverse(rec->ring+rec->first*no, (rec->rows-rec->first)*no);
+    recorder_reverse(rec->ring, rec->rows*no);
+    rec->first=0;
+  }
+  return rec->ring;
+}
+
+double recorder_time(const sm_recorder *rec, size_t row){
+  return recorder_at(rec, rec->sampled-rec->rows+row);
+}
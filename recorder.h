@@ -0,0 +1,107 @@
+/*******************************************************************************
+*    This file is part of Sage-Markov.
+*
+*    Sage-Markov is free software: you can redistribute it and/or modify
+*    it under the terms of the GNU AFFERO GENERAL PUBLIC LICENSE as published by
+*    the Free Software Foundation, either version 3 of the License, or
+*    (at your option) any later version.
+*
+*    Sage-Markov is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU AFFERO GENERAL PUBLIC LICENSE for more details.
+
+*    You should have received a copy of the GNU AFFERO GENERAL PUBLIC LICENSE
+*    along with Sage-Markov.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __RECORDER_H___
+#define __RECORDER_H___
+
+#include <sagemarkov.h>
+
+/*
+** Observables sampled at equally spaced times, or at the ascending times
+** of a list, while the walk steps.
+**
+** An attached recorder is sampled by markov_step and nsm_step after the
+** time of the next event is drawn and before the event fires, every
+** sample time start + k*interval the step passes sees the state that
+** held at that time. run_walk_until samples the times up to and including
+** its end. The rows go into a ring of capacity rows, one column per
+** observable, the oldest row is overwritten when it is full;
+** recorder_data returns the rows held, oldest first, as one array.
+**
+** leap_walk_until and split_walk_until do not sample, the times they pass
+** become rows of NAN at the next sample and are counted as missed.
+*/
+
+typedef double (*sm_observable)(const sm_context *ctx);
+
+enum { SM_RECORD_REACTIVITY, SM_RECORD_WALKERS, SM_RECORD_REGION, SM_RECORD_FUNCTION };
+
+typedef struct SM_RECORD{
+  int kind;
+  size_t *lo, *hi;              /* SM_RECORD_REGION: lo[d] <= x[d] < hi[d] */
+  sm_observable f;              /* SM_RECORD_FUNCTION                      */
+} sm_record;
+
+typedef struct SM_RECORDER{
+  /* set by recorder_create and recorder_add_* */
+  double start, interval;
+  const double *times;          /* recorder_create_times: the sample times,
+                                   capacity of them, NULL: the grid      */
+  size_t capacity;              /* rows kept                              */
+  size_t number_of_observables;
+  sm_record *observables;
+
+  /* maintained while attached */
+  double *ring;                 /* [row*number_of_observables+observable] */
+  size_t first, rows;           /* oldest row in ring, rows held          */
+  size_t sampled;               /* sample times passed, the next one is
+                                   start + sampled*interval or
+                                   times[sampled]                         */
+  size_t missed;                /* rows of NAN                            */
+} sm_recorder;
+
+/* samples at start, start+interval, ..., keeps the last capacity; 0 or -1 */
+int recorder_create(sm_recorder *rec, double start, double interval, size_t capacity);
+
+/*
+** samples at times[0..number_of_times), ascending, and keeps them all;
+** times is not copied and has to live as long as rec; 0 or -1
+*/
+int recorder_create_times(sm_recorder *rec, const double *times, size_t number_of_times);
+
+void recorder_destroy(sm_recorder *rec);
+
+/*
+** adding observables before the recorder is attached, each returns its
+** column or -1: the total reactivity, the walkers of all cells (kept
+** total if moments are started, see moments.h), of the cells in the box
+** lo <= x < hi of topology, and any function of ctx
+*/
+int recorder_reactivity(sm_recorder *rec);
+int recorder_walkers(sm_recorder *rec);
+int recorder_region(sm_recorder *rec, const sm_topology *topology,
+                    const size_t *lo, const size_t *hi);
+int recorder_function(sm_recorder *rec, sm_observable f);
+
+/*
+** attaches rec to ctx, the first sample is the first time of the grid not
+** before ctx->markov_time; 0, or -1 if the ring cannot be allocated
+*/
+int recorder_attach(sm_context *ctx, sm_recorder *rec);
+
+void recorder_detach(sm_context *ctx);
+
+/* records the sample times before time from the present state */
+void recorder_sample(sm_context *ctx, double time);
+
+/* the rows held, oldest first; reorders the ring in place */
+const double *recorder_data(sm_recorder *rec);
+
+/* the time of row of recorder_data */
+double recorder_time(const sm_recorder *rec, size_t row);
+
+#endif
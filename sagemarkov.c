@@ -16,70 +16,391 @@
 */
 
 #include <sagemarkov.h>
+#include <recorder.h>
+#include <moments.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+/*
+** ctx has to be zeroed (or destroyed) before create_walk is called,
+** the topology has to live as long as the walk; returns 0, 1 if ctx
+** holds a walk already, -1 if the cells cannot be allocated
+*/
+int create_walk(sm_context *ctx, const sm_topology *topology, size_t init_number_of_cells,
+                unsigned long init_seed, double init_timescale){
+  return create_walk_seeded(ctx, topology, init_number_of_cells, init_seed,
+                            init_timescale, SM_SEED_DEFAULT);
+}
 
-lc_global lc_g;
-cell * cells;
-size_t number_of_cells;
-double markov_time, timescale;
-
-unsigned long seed;
-
-int create_walk(size_t init_number_of_cells, unsigned long init_seed, double init_timescale){
+int create_walk_seeded(sm_context *ctx, const sm_topology *topology, size_t init_number_of_cells,
+                       unsigned long init_seed, double init_timescale, int seeding){
   
-  markov_time = 0;
-  timescale = init_timescale;
+  ctx->markov_time = 0;
+  ctx->timescale = init_timescale;
   
-  if(cells){
+  if(ctx->cells){
     return 1;
   }
 
-  number_of_cells=init_number_of_cells;
+  ctx->topology=topology;
+  ctx->number_of_cells=init_number_of_cells;
 
-  cells=(cell*) calloc(sizeof(cell), number_of_cells);
-  seed=init_rand55(init_seed);
-  lc_init(&lc_g,number_of_cells,NULL,timescale);
+  ctx->cells=(cell*) calloc(sizeof(cell), ctx->number_of_cells);
+  if(!ctx->cells){
+    ctx->number_of_cells=0;
+    return -1;
+  }
+  ctx->seed = seeding == SM_SEED_HASH ? init_rand55_hash_r(&ctx->rng, init_seed)
+                                      : init_rand55_r(&ctx->rng, init_seed);
+  lc_init(&ctx->lc,ctx->number_of_cells,NULL,ctx->timescale);
+  ctx->lc.rng=&ctx->rng;
+  lc_ued_array(&ctx->lc,ctx->cells,sizeof(cell));
+  ctx->recorder=NULL;
+  ctx->record_at=INFINITY;
+  ctx->moments=NULL;
 
-  for( size_t i=0; i<number_of_cells; i++){
-    cells[i].lc_ev=NULL;
+  for( size_t i=0; i<ctx->number_of_cells; i++){
+    ctx->cells[i].lc_ev=NULL;
   }
  
   return 0;
 }
 
-int destroy_walk(){
-  if(cells){
-    lc_clear(&lc_g);
-    free(cells);
-    cells=NULL;
-    number_of_cells=0;
+int destroy_walk(sm_context *ctx){
+  if(ctx->cells){
+    nsm_free(ctx);
+    recorder_detach(ctx);
+    moments_stop(ctx);
+    lc_clear(&ctx->lc);
+    free(ctx->cells);
+    ctx->cells=NULL;
+    ctx->number_of_cells=0;
     return 0;
   }
   return 1;
 }
 
-int run_walk(size_t nrun){
+/*
+** Checkpoints: save_state writes the walk to a binary file, load_state
+** continues it in another process. The file is
+**   header          magic, version, build and sizes, see sm_state_header
+**   sizes           topology->sizes[0..dimension]
+**   rng             rand55_state
+**   lc              lc_save
+**   cells           with lc_ev as led index + 1, 0 for none
+** load_state maps the file and takes the classes as they are, nothing is
+** entered through lc_enter, the run continues bit for bit as the saved
+** one would. The model parameters, e.g. the rates, are not in the file,
+** neither are a recorder and the moments. A walk under the next-subvolume engine is not
+** saved.
+*/
+#define SM_STATE_MAGIC   "SMSTATE"
+#define SM_STATE_VERSION 1
+#define SM_STATE_BLOCK   4096
+
+typedef struct SM_STATE_HEADER{
+  char     magic[8];
+  uint32_t version;
+  uint32_t build;           /* compile time options, see sm_state_build */
+  uint32_t cell_size, event_size, class_size, rng_size, reactivity_size;
+  int32_t  dimension;
+  uint64_t number_of_cells, seed;
+  double   markov_time, timescale;
+} sm_state_header;
+
+static uint32_t sm_state_build(void){
+  uint32_t b = LC_SELECTION;
+#ifdef LC_CLASS_TREE
+  b |= 1<<4;
+#endif
+#ifdef LC_CLASS_CHUNKS
+  b |= 1<<5;
+#endif
+#ifdef LC_COMPACT_EVENTS
+  b |= 1<<6;
+#endif
+#ifdef LC_STATS
+  b |= 1<<7;
+#endif
+#ifdef RAND55_PHILOX
+  b |= 1<<8;
+#endif
+  return b | (uint32_t)LC_REACTIVITY_TYPE << 16;
+}
+
+static void sm_state_header_fill(sm_state_header *h){
+  memset(h, 0, sizeof(*h));
+  memcpy(h->magic, SM_STATE_MAGIC, sizeof(SM_STATE_MAGIC));
+  h->version         = SM_STATE_VERSION;
+  h->build           = sm_state_build();
+  h->cell_size       = sizeof(cell);
+  h->event_size      = sizeof(lc_event);
+  h->class_size      = sizeof(lc_class);
+  h->rng_size        = sizeof(rand55_state);
+  h->reactivity_size = sizeof(lc_reactivity_t);
+}
+
+int save_state(const sm_context *ctx, const char *filename){
+  sm_state_header h;
+  cell buf[SM_STATE_BLOCK];
+  size_t b, n, i;
+  FILE *f;
+  int err;
+
+  if(!ctx->cells || ctx->nsm)
+    return -1;
+#ifdef LC_CLASS_CHUNKS
+  /* the leds are spread over chunks, lc_save does not write them */
+  return -1;
+#endif
+  if(!(f = fopen(filename, "wb")))
+    return -1;
+
+  sm_state_header_fill(&h);
+  h.dimension       = ctx->topology->dimension;
+  h.number_of_cells = ctx->number_of_cells;
+  h.seed            = ctx->seed;
+  h.markov_time     = ctx->markov_time;
+  h.timescale       = ctx->timescale;
+  fwrite(&h, sizeof(h), 1, f);
+  fwrite(ctx->topology->sizes, sizeof(size_t), h.dimension+1, f);
+  err = rand55_save(&ctx->rng, f);
+  err |= lc_save(&ctx->lc, f, ctx->cells, sizeof(cell));
+
+  for(b = 0; b < ctx->number_of_cells; b += n){
+    n = ctx->number_of_cells - b < SM_STATE_BLOCK ? ctx->number_of_cells - b : SM_STATE_BLOCK;
+    memcpy(buf, ctx->cells + b, n*sizeof(cell));
+    for(i = 0; i < n; i++)
+      buf[i].lc_ev = buf[i].lc_ev ? (lc_event*)(uintptr_t)(buf[i].lc_ev - ctx->lc.events + 1) : NULL;
+    fwrite(buf, sizeof(cell), n, f);
+  }
+
+  err |= ferror(f);
+  err |= fclose(f);
+  return err ? -1 : 0;
+}
+
+/*
+** whether the leds loaded and the cells refer to each other: every led of
+** a class belongs to one of the n cells, the classes do not overlap, and
+** the led of every cell, given as index + 1, lies in a class and belongs
+** to that cell and no other
+*/
+static int sm_state_check(const lc_global *lc, const cell *cells, size_t n){
+#ifdef LC_CLASS_CHUNKS
+  return 0;                     /* never saved, see save_state */
+#else
+  unsigned char *used = calloc(lc->max_events, 1);
+  const lc_class *cd;
+  const lc_event *led;
+  size_t i, e;
+  int ok = 0;
+
+  if(!used)
+    return 0;
+  for(cd = lc->cbeg; cd < lc->cend; cd++)
+    for(led = cd->bot; led < cd->top; led++){
+      uintptr_t u = (uintptr_t) LC_UED(lc, led);
+      if(used[led - lc->events] || u < (uintptr_t) cells
+         || (u - (uintptr_t) cells) % sizeof(cell)
+         || (u - (uintptr_t) cells) / sizeof(cell) >= n)
+        goto done;
+      used[led - lc->events] = 1;
+    }
+  for(i = 0; i < n; i++){
+    if(!cells[i].lc_ev)
+      continue;
+    e = (uintptr_t) cells[i].lc_ev - 1;
+    if(e >= lc->max_events || used[e] != 1
+       || LC_UED(lc, lc->events + e) != (void*)(cells + i))
+      goto done;
+    used[e] = 2;
+  }
+  ok = 1;
+
+done:
+  free(used);
+  return ok;
+#endif
+}
+
+/* the sizes of create_topology: sizes[0] is 1 and each size divides the
+   next and the number of cells, so neighbour stays inside the cells */
+static int sm_state_sizes_check(const size_t *sizes, int dimension, uint64_t n){
+  int d;
+
+  if(sizes[0] != 1)
+    return 0;
+  for(d = 0; d < dimension; d++)
+    if(!sizes[d+1] || sizes[d+1] % sizes[d])
+      return 0;
+  return n && n % sizes[dimension] == 0;
+}
+
+/* the buffer position and the lags of a saved generator */
+static int sm_state_rng_check(const rand55_state *rng){
+#ifdef RAND55_PHILOX
+  return rng->left <= RAND55_BLOCK;
+#else
+  if(rng->j < 0 || rng->j > rand55_K || rng->k < 0 || rng->k > rand55_K)
+    return 0;
+#if RAND55_BLOCK
+  if(rng->filled != 0 && rng->filled != 1)
+    return 0;
+  return rng->left <= (rng->filled ? RAND55_BLOCK : 0);
+#else
+  return 1;
+#endif
+#endif
+}
+
+/*
+** ctx has to be zeroed (or destroyed) and topology empty, both are set up
+** as create_topology and create_walk would have; returns 0, or -1 if the
+** file cannot be read, comes from another version or build, or its
+** topology, random state, classes and cells do not fit together; ctx is
+** left untouched then
+*/
+int load_state(sm_context *ctx, sm_topology *topology, const char *filename){
+  sm_state_header h, want;
+  rand55_state rng;
+  struct stat st;
+  const char *map, *p, *end;
+  size_t *sizes = NULL, i;
+  cell *cells = NULL;
+  lc_global lc;
+  int fd, ok = 0;
+
+  if(ctx->cells)
+    return -1;
+  if((fd = open(filename, O_RDONLY)) < 0)
+    return -1;
+  if(fstat(fd, &st) || (size_t)st.st_size < sizeof(h)){
+    close(fd);
+    return -1;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+    return -1;
+  madvise((void*)map, st.st_size, MADV_SEQUENTIAL);
+  p = map;
+  end = map + st.st_size;
+
+  memcpy(&h, p, sizeof(h));
+  p += sizeof(h);
+  sm_state_header_fill(&want);
+  if(memcmp(h.magic, want.magic, sizeof(h.magic)) || h.version != want.version
+     || h.build != want.build || h.cell_size != want.cell_size
+     || h.event_size != want.event_size || h.class_size != want.class_size
+     || h.rng_size != want.rng_size || h.reactivity_size != want.reactivity_size){
+    fprintf(stderr, "load_state: %s is not a state of this version and build\n", filename);
+    goto done;
+  }
+  if(h.dimension < 1 || (size_t)(end - p) < (h.dimension+1)*sizeof(size_t) + sizeof(rand55_state))
+    goto done;
+  if(!(sizes = malloc((h.dimension+1)*sizeof(size_t))))
+    goto done;
+  memcpy(sizes, p, (h.dimension+1)*sizeof(size_t));
+  p += (h.dimension+1)*sizeof(size_t);
+  memcpy(&rng, p, sizeof(rand55_state));
+  p += sizeof(rand55_state);
+  if(!sm_state_sizes_check(sizes, h.dimension, h.number_of_cells)
+     || h.number_of_cells > SIZE_MAX/sizeof(cell) || !sm_state_rng_check(&rng)){
+    fprintf(stderr, "load_state: %s has a broken topology or random state\n", filename);
+    goto done;
+  }
+
+  if(!(cells = malloc(h.number_of_cells*sizeof(cell))))
+    goto done;
+  if(!(p = lc_load(&lc, p, end, cells, sizeof(cell))))
+    goto done;
+  if((size_t)(end - p) < h.number_of_cells*sizeof(cell)){
+    lc_clear(&lc);
+    goto done;
+  }
+  memcpy(cells, p, h.number_of_cells*sizeof(cell));
+  if(!sm_state_check(&lc, cells, h.number_of_cells)){
+    fprintf(stderr, "load_state: %s has leds out of range\n", filename);
+    lc_clear(&lc);
+    goto done;
+  }
+  for(i = 0; i < h.number_of_cells; i++)
+    if(cells[i].lc_ev)
+      cells[i].lc_ev = lc.events + ((uintptr_t)cells[i].lc_ev - 1);
+
+  topology->dimension   = h.dimension;
+  topology->sizes       = sizes;
+  ctx->topology         = topology;
+  ctx->cells            = cells;
+  ctx->number_of_cells  = h.number_of_cells;
+  ctx->seed             = h.seed;
+  ctx->markov_time      = h.markov_time;
+  ctx->timescale        = h.timescale;
+  ctx->nsm              = NULL;
+  ctx->recorder         = NULL;
+  ctx->record_at        = INFINITY;
+  ctx->moments          = NULL;
+  ctx->rng              = rng;
+  ctx->lc               = lc;
+  ctx->lc.rng           = &ctx->rng;
+  sizes = NULL;
+  cells = NULL;
+  ok = 1;
+
+done:
+  free(sizes);
+  free(cells);
+  munmap((void*)map, st.st_size);
+  return ok ? 0 : -1;
+}
+
+/* one step of the engine selected, whether any cell can still fire and
+   whether none ever could */
+static double walk_step(sm_context *ctx){
+  return ctx->nsm ? nsm_step(ctx) : markov_step(ctx);
+}
+
+static int walk_active(const sm_context *ctx){
+  if(ctx->nsm)
+    return ctx->nsm->tau[ctx->nsm->heap[0]] < INFINITY;
+  return ctx->lc.r > LC_EPS(&ctx->lc);
+}
+
+static int walk_empty(const sm_context *ctx){
+  if(ctx->nsm)
+    return !walk_active(ctx);
+  return ctx->lc.r < LC_EPS(&ctx->lc);
+}
+
+int run_walk(sm_context *ctx, size_t nrun){
 
-  if( lc_g.r < lc_g.eps ){
+  if( walk_empty(ctx) ){
      printf("model not initialized, reactivity is 0 \n");
      return -1;
   }
   
-  for(size_t i=0;  ( nrun==0 || i<nrun ) && lc_g.r > lc_g.eps ; i++){
-    markov_time+=markov_step();
+  for(size_t i=0;  ( nrun==0 || i<nrun ) && walk_active(ctx) ; i++){
+    ctx->markov_time+=walk_step(ctx);
   }
   return 0;
 }
 
-size_t run_walk_until(double time){
-  if( lc_g.r < lc_g.eps ){
+size_t run_walk_until(sm_context *ctx, double time){
+  if( walk_empty(ctx) ){
 //    printf("model not initialized, reactivity is 0 \n");
      return -1;
   }
   size_t step=0;
-  while (markov_time < time  && lc_g.r > lc_g.eps) {
-    markov_time+=markov_step();
+  while (ctx->markov_time < time  && walk_active(ctx)) {
+    ctx->markov_time+=walk_step(ctx);
     step++;
   }
+  /* the state holds from markov_time on, up to and including time */
+  if( isfinite(time) && nextafter(time, INFINITY) > ctx->record_at )
+    recorder_sample(ctx, nextafter(time, INFINITY));
   return step;
 }
\ No newline at end of file
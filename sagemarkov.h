@@ -20,19 +20,39 @@
 
 #include <logclass.h>
 #include <randomwalk.h>
+#include <nsm.h>
+
+/* the walker moments have to be counted again, see moments.h */
+void moments_invalidate(sm_context *ctx);
+
+void update_reactivity(sm_context *ctx, size_t index){
+ if(ctx->moments)
+   moments_invalidate(ctx);
+ if(ctx->nsm){
+   nsm_update(ctx, index);
+   return;
+ }
+ ( ctx->cells+index) -> lc_ev = lc_enter( &ctx->lc, ctx->cells+index, reactivity( ctx, index ) );
+}
 
-cell * cells;
-size_t number_of_cells;
-double markov_time, timescale;
+/*
+** seeding of the random stream of a walk: SM_SEED_DEFAULT by
+** init_rand55_r, the warm-up of 10^7 steps unless built with
+** RAND55_HASH_INIT, SM_SEED_HASH by init_rand55_hash_r, a few
+** microseconds, with other sequences; see rand55.h
+*/
+enum { SM_SEED_DEFAULT, SM_SEED_HASH };
 
-unsigned long seed;
+/* create_walk seeding the stream as seeding says */
+int create_walk_seeded(sm_context *ctx, const sm_topology *topology, size_t init_number_of_cells,
+                       unsigned long init_seed, double init_timescale, int seeding);
 
-void update_reactivity(size_t index){
- ( cells+index) -> lc_ev = lc_enter( &lc_g, cells+index, reactivity( index ) );
-}
+/* binary checkpoint of a walk, see sagemarkov.c; 0 on success, else -1 */
+int save_state(const sm_context *ctx, const char *filename);
+int load_state(sm_context *ctx, sm_topology *topology, const char *filename);
 
-lc_reactivity_t global_reactivity(){
-   return lc_g.r;
+lc_reactivity_t global_reactivity(const sm_context *ctx){
+   return ctx->nsm ? ctx->nsm->total : ctx->lc.r;
 }
 
 
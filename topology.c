@@ -3,41 +3,52 @@
 
 
 
-int dimension(){
-    return topological_dimension;
+int dimension(const sm_topology *topology){
+    return topology->dimension;
 };
 
-size_t topological_volume(){
-    return topological_sizes[topological_dimension];
+size_t topological_volume(const sm_topology *topology){
+    return topology->sizes[topology->dimension];
 };
 
-cell * random_neighbour(cell * source) {
-/* draw dest cell, right or left neighbour */
+cell * neighbour(const sm_context *ctx, cell * source, size_t neighbour) {
+/* neighbour 2d is left, 2d+1 right of source in dimension d */
       cell * dest;
-      const size_t neighbour=rand55() % (2*topological_dimension);
+      const sm_topology *topology=ctx->topology;
       if(neighbour & 1){ /* bad example */
-        dest=source+topological_sizes[neighbour/2];
-        if(dest>=cells+number_of_cells) /* cyclic boundaries: right out, left in */
-          dest-=number_of_cells;
+        dest=source+topology->sizes[neighbour/2];
+        if(dest>=ctx->cells+ctx->number_of_cells) /* cyclic boundaries: right out, left in */
+          dest-=ctx->number_of_cells;
       }
       else{
-        dest=source-topological_sizes[neighbour/2];
-        if(dest<cells) /* cyclic boundaries: left out, right in */
-          dest+=number_of_cells;
+        dest=source-topology->sizes[neighbour/2];
+        if(dest<ctx->cells) /* cyclic boundaries: left out, right in */
+          dest+=ctx->number_of_cells;
       }
       return dest;
 };
 
+cell * random_neighbour(sm_context *ctx, cell * source) {
+/* draw dest cell, right or left neighbour */
+      return neighbour(ctx, source, rand55_r(&ctx->rng) % (2*ctx->topology->dimension));
+};
+
 
-size_t create_topology(const int dimension, const size_t edge){
+size_t create_topology(sm_topology *topology, const int dimension, const size_t edge){
 
-    topological_dimension=dimension;
-    topological_sizes=calloc(topological_dimension+1,sizeof(size_t));
+    topology->dimension=dimension;
+    topology->sizes=calloc(topology->dimension+1,sizeof(size_t));
 
     size_t d_shift=1;
-    for(size_t d=0; d<=topological_dimension; d++){
-        topological_sizes[d]=d_shift;
+    for(size_t d=0; d<=topology->dimension; d++){
+        topology->sizes[d]=d_shift;
         d_shift*=edge;
     }
     return d_shift;
 }
+
+void destroy_topology(sm_topology *topology){
+    free(topology->sizes);
+    topology->sizes=NULL;
+    topology->dimension=0;
+}
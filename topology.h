@@ -1,15 +1,23 @@
 #ifndef __TOPOLOGY_H__
 #define __TOPOLOGY_H__
 
-size_t number_of_cells, sizes[];
+/*
+** hypercube with cyclic boundaries, sizes[d] is edge^d for d up to
+** dimension; create_topology returns the number of cells, edge^(dimension+1).
+** A topology is read only after create_topology and may be shared by
+** several simulation contexts.
+*/
+typedef struct SM_TOPOLOGY{
+  int dimension;
+  size_t *sizes;
+} sm_topology;
 
-int topological_dimension;
-size_t *topological_sizes;
+int dimension(const sm_topology *topology);
 
-int dimension();
+size_t topological_volume(const sm_topology *topology);
 
-size_t topological_volume();
+size_t create_topology(sm_topology *topology, const int dimension, const size_t edge);
 
-cell * random_neighbour(cell * source);
+void destroy_topology(sm_topology *topology);
 
-#endif 
\ No newline at end of file
+#endif 
@@ -0,0 +1,368 @@
+/* generated by createziggurat.c, do not edit */
+#include "rand55.h"
+
+/* exp: 256 layers, r = 7.6971174701310497, v = 0.0039496598225815572 */
+const double rand55_zexp_r = 7.6971174701310497;
+const rand55_t rand55_zexp_k[256] = {
+  63772366859451966UL, 64979414100166147UL, 67254589511982478UL, 68340206366438375UL,
+  68984669232786830UL, 69414802082015476UL, 69723845488959290UL, 69957458710765731UL,
+  70140739975225424UL, 70288673577553175UL, 70410779876359901UL, 70513409253215124UL,
+  70600966658792998UL, 70676607521985340UL, 70742653925960027UL, 70800854274351335UL,
+  70852551217600102UL, 70898793638218033UL, 70940413345668314UL, 70978078840904825UL,
+  71012333790212155UL, 71043625065918400UL, 71072323521159402UL, 71098739610587032UL,
+  71123135293946831UL, 71145733218205131UL, 71166723879689769UL, 71186271267966443UL,
+  71204517355319385UL, 71221585699117231UL, 71237584355722410UL, 71252608255217664UL,
+  71266741150257312UL, 71280057225865705UL, 71292622437299477UL, 71304495628286276UL,
+  71315729470730328UL, 71326371258395551UL, 71336463580465196UL, 71346044895743292UL,
+  71355150024248851UL, 71363810569793572UL, 71372055284630174UL, 71379910385263103UL,
+  71387399826913848UL, 71394545542844048UL, 71401367653695246UL, 71407884651153947UL,
+  71414113559555233UL, 71420070078466790UL, 71425768708823712UL, 71431222864793787UL,
+  71436444973228000UL, 71441446562279629UL, 71446238340547948UL, 71450830267911276UL,
+  71455231619052821UL, 71459451040546132UL, 71463496602251055UL, 71467375843672282UL,
+  71471095815848246UL, 71474663119265857UL, 71478083938234533UL, 71481364072099545UL,
+  71484508963628596UL, 71487523724865630UL, 71490413160711291UL, 71493181790459337UL,
+  71495833867492137UL, 71498373397315467UL, 71500804154092835UL, 71503129695821994UL,
+  71505353378280893UL, 71507478367856769UL, 71509507653360103UL, 71511444056914612UL,
+  71513290244005108UL, 71515048732756768UL, 71516721902512005UL, 71518312001764598UL,
+  71519821155504922UL, 71521251372024900UL, 71522604549226701UL, 71523882480475022UL,
+  71525086860029082UL, 71526219288087140UL, 71527281275473317UL, 71528274247993831UL,
+  71529199550487312UL, 71530058450591678UL, 71530852142248054UL, 71531581748960457UL,
+  71532248326828301UL, 71532852867367356UL, 71533396300133403UL, 71533879495161654UL,
+  71534303265233874UL, 71534668367984138UL, 71534975507853227UL, 71535225337900829UL,
+  71535418461483946UL, 71535555433809157UL, 71535636763365798UL, 71535662913246459UL,
+  71535634302360675UL, 71535551306547169UL, 71535414259589535UL, 71535223454139787UL,
+  71534979142553819UL, 71534681537642422UL, 71534330813341135UL, 71533927105301908UL,
+  71533470511409187UL, 71532961092222788UL, 71532398871349588UL, 71531783835745850UL,
+  71531115935951685UL, 71530395086258953UL, 71529621164813635UL, 71528794013653504UL,
+  71527913438681672UL, 71526979209576400UL, 71525991059637307UL, 71524948685567941UL,
+  71523851747194430UL, 71522699867119736UL, 71521492630312815UL, 71520229583631778UL,
+  71518910235279921UL, 71517534054193275UL, 71516100469358101UL, 71514608869056507UL,
+  71513058600038129UL, 71511448966615578UL, 71509779229681057UL, 71508048605641307UL,
+  71506256265267736UL, 71504401332458279UL, 71502482882907219UL, 71500499942678846UL,
+  71498451486680476UL, 71496336437029960UL, 71494153661312391UL, 71491901970720292UL,
+  71489580118071069UL, 71487186795695018UL, 71484720633186629UL, 71482180195011326UL,
+  71479563977959155UL, 71476870408436239UL, 71474097839584092UL, 71471244548216038UL,
+  71468308731559162UL, 71465288503789229UL, 71462181892345006UL, 71458986834007281UL,
+  71455701170726678UL, 71452322645183017UL, 71448848896057533UL, 71445277452997683UL,
+  71441605731252537UL, 71437831025954848UL, 71433950506023841UL, 71429961207660465UL,
+  71425860027404361UL, 71421643714719047UL, 71417308864068809UL, 71412851906447444UL,
+  71408269100315339UL, 71403556521897301UL, 71398710054789097UL, 71393725378815673UL,
+  71388597958078561UL, 71383323028123847UL, 71377895582155357UL, 71372310356210134UL,
+  71366561813204955UL, 71360644125753250UL, 71354551157641374UL, 71348276443841527UL,
+  71341813168925545UL, 71335154143729165UL, 71328291780099919UL, 71321218063543343UL,
+  71313924523561363UL, 71306402201453252UL, 71298641615323005UL, 71290632722006958UL,
+  71282364875601445UL, 71273826782231580UL, 71265006450658284UL, 71255891138270493UL,
+  71246467291952156UL, 71236720483248102UL, 71226635337177550UL, 71216195453957639UL,
+  71205383322799734UL, 71194180226826268UL, 71182566138022868UL, 71170519600986116UL,
+  71158017604047883UL, 71145035436147858UL, 71131546527581333UL, 71117522272462553UL,
+  71102931830406849UL, 71087741904537352UL, 71071916492452027UL, 71055416606229074UL,
+  71038199956884842UL, 71020220597905366UL, 71001428521521943UL, 70981769200257180UL,
+  70961183064886034UL, 70939604908280264UL, 70916963202563155UL, 70893179314503599UL,
+  70868166601008646UL, 70841829362781881UL, 70814061629508051UL, 70784745744050080UL,
+  70753750705772346UL, 70720930223797197UL, 70686120419179408UL, 70649137099867236UL,
+  70609772512857270UL, 70567791452710400UL, 70522926572607765UL, 70474872700653692UL,
+  70423279906342873UL, 70367744984566373UL, 70307800919443506UL, 70242903746324883UL,
+  70172416030884774UL, 70095585904503693UL, 70011520197573590UL, 69919149639120313UL,
+  69817183251637536UL, 69704047819548291UL, 69577806412166213UL, 69436047003274869UL,
+  69275727574543036UL, 69092956530246901UL, 68882674626163184UL, 68638182861185893UL,
+  68350421938584857UL, 68006836680507834UL, 67589518041345615UL, 67072025674998669UL,
+  66413657698387356UL, 65548422570167198UL, 64362011160684762UL, 62638351605965797UL,
+  59916484124968305UL, 55019202988859519UL, 43886863762689022UL, 0UL};
+const double rand55_zexp_w[256] = {
+  1.2069675079011479e-16, 1.0681896298230034e-16, 9.6326191875401206e-17,
+  8.9905562076117022e-17, 8.5267413487861613e-17, 8.1631150669550509e-17,
+  7.8637237935969464e-17, 7.6090392702261351e-17, 7.3872720520651283e-17,
+  7.1907581018791648e-17, 7.0142343183439492e-17, 6.85393004282338e-17,
+  6.7070512213900266e-17, 6.5714697525278438e-17, 6.4455272860976041e-17,
+  6.3279063401801999e-17, 6.2175427952399251e-17, 6.1135647842402621e-17,
+  6.0152489660365474e-17, 5.9219885665781155e-17, 5.8332695808893447e-17,
+  5.7486527561324151e-17, 5.6677597482072926e-17, 5.590262342824915e-17,
+  5.5158739612950876e-17, 5.4443428933674398e-17, 5.3754468520843382e-17,
+  5.3089885522804813e-17, 5.2447920900917487e-17, 5.1826999553636309e-17,
+  5.1225705486288283e-17, 5.0642761036957166e-17, 5.0077009388206773e-17,
+  4.9527399759834687e-17, 4.8992974803892862e-17, 4.8472859820098693e-17,
+  4.7966253484865173e-17, 4.7472419845860932e-17, 4.6990681380203206e-17,
+  4.6520412951002593e-17, 4.6061036526195264e-17, 4.5612016547056783e-17,
+  4.5172855852738255e-17, 4.4743092082553456e-17, 4.4322294490309898e-17,
+  4.3910061115287245e-17, 4.3506016262968027e-17, 4.3109808255667801e-17,
+  4.272110741907046e-17, 4.2339604275568813e-17, 4.1965007919415553e-17,
+  4.1597044552145894e-17, 4.1235456159653539e-17, 4.0879999314778004e-17,
+  4.0530444091368143e-17, 4.0186573077584965e-17, 3.9848180477746412e-17,
+  3.9515071293338822e-17, 3.9187060574958292e-17, 3.8863972737928329e-17,
+  3.8545640935191378e-17, 3.8231906481810759e-17, 3.792261832606254e-17,
+  3.7617632562657729e-17, 3.7316811984125566e-17, 3.7020025666818322e-17,
+  3.6727148588375355e-17, 3.6438061273816166e-17, 3.6152649467724945e-17,
+  3.587080383024772e-17, 3.5592419654852178e-17, 3.5317396606003166e-17,
+  3.5045638475087292e-17, 3.477705295308045e-17, 3.4511551418595211e-17,
+  3.4249048740072688e-17, 3.3989463090997733e-17, 3.3732715777118615e-17,
+  3.3478731074744067e-17, 3.3227436079273064e-17, 3.2978760563186782e-17,
+  3.2732636842799055e-17, 3.2488999653121835e-17, 3.2247786030256637e-17,
+  3.2008935200772135e-17, 3.1772388477572653e-17, 3.1538089161802711e-17,
+  3.1305982450369461e-17, 3.1076015348698148e-17, 3.084813658836611e-17,
+  3.062229654928838e-17, 3.0398447186153198e-17, 3.0176541958828663e-17,
+  2.9956535766482796e-17, 2.973838488517846e-17, 2.9522046908722177e-17,
+  2.9307480692561974e-17, 2.9094646300544185e-17, 2.8883504954352669e-17,
+  2.8674018985466392e-17, 2.8466151789482764e-17, 2.8259867782664671e-17,
+  2.8055132360578856e-17, 2.785191185870226e-17, 2.76501735148812e-17,
+  2.7449885433535884e-17, 2.72510165515098e-17, 2.705353660547006e-17,
+  2.6857416100770791e-17, 2.6662626281697239e-17, 2.6469139103013449e-17,
+  2.6276927202741159e-17, 2.6085963876101998e-17, 2.5896223050559214e-17,
+  2.5707679261898974e-17, 2.5520307631294861e-17, 2.533408384330248e-17,
+  2.5148984124734183e-17, 2.4964985224366776e-17, 2.4782064393437739e-17,
+  2.4600199366887968e-17, 2.4419368345311363e-17, 2.4239549977573742e-17,
+  2.4060723344065549e-17, 2.3882867940554706e-17, 2.3705963662607709e-17,
+  2.3529990790548651e-17, 2.335492997492741e-17, 2.3180762222469619e-17,
+  2.3007468882482348e-17, 2.2835031633690653e-17, 2.2663432471481271e-17,
+  2.2492653695530797e-17, 2.2322677897796657e-17, 2.2153487950850081e-17,
+  2.1985066996531142e-17, 2.1817398434906675e-17, 2.1650465913512605e-17,
+  2.1484253316862896e-17, 2.1318744756207873e-17, 2.1153924559525278e-17,
+  2.0989777261727859e-17, 2.0826287595071775e-17, 2.0663440479750461e-17,
+  2.0501221014658975e-17, 2.033961446831413e-17, 2.0178606269915983e-17,
+  2.0018182000536458e-17, 1.9858327384421051e-17, 1.9699028280389702e-17,
+  1.954027067332297e-17, 1.9382040665719715e-17, 1.9224324469312461e-17,
+  1.9067108396726571e-17, 1.8910378853169242e-17, 1.8754122328134211e-17,
+  1.8598325387107825e-17, 1.8442974663261895e-17, 1.8288056849118447e-17,
+  1.8133558688171097e-17, 1.7979466966447376e-17, 1.7825768503995817e-17,
+  1.7672450146281064e-17, 1.7519498755469644e-17, 1.7366901201588299e-17,
+  1.7214644353536014e-17, 1.7062715069929973e-17, 1.6911100189764693e-17,
+  1.6759786522862492e-17, 1.6608760840092262e-17, 1.6458009863332156e-17,
+  1.6307520255150362e-17, 1.6157278608176493e-17, 1.6007271434134368e-17,
+  1.585748515250497e-17, 1.5707906078786231e-17, 1.5558520412313906e-17,
+  1.5409314223605189e-17, 1.5260273441183826e-17, 1.5111383837842319e-17,
+  1.4962631016293314e-17, 1.4814000394158369e-17, 1.4665477188238072e-17,
+  1.4517046398002727e-17, 1.4368692788237616e-17, 1.4220400870771058e-17,
+  1.4072154885207093e-17, 1.3923938778577468e-17, 1.3775736183819727e-17,
+  1.3627530396979381e-17, 1.3479304353024357e-17, 1.3331040600148934e-17,
+  1.3182721272432205e-17, 1.3034328060702357e-17, 1.2885842181442774e-17,
+  1.2737244343558675e-17, 1.2588514712803686e-17, 1.243963287364384e-17,
+  1.2290577788311889e-17, 1.2141327752776902e-17, 1.1991860349322497e-17,
+  1.1842152395391188e-17, 1.1692179888311411e-17, 1.1541917945477235e-17,
+  1.1391340739497387e-17, 1.1240421427769196e-17, 1.1089132075862816e-17,
+  1.0937443574020229e-17, 1.0785325545980141e-17, 1.0632746249231653e-17,
+  1.0479672465673924e-17, 1.0326069381512547e-17, 1.0171900455052203e-17,
+  1.0017127270844318e-17, 9.8617093784122382e-18, 9.7056041134973106e-18,
+  9.5487663994385323e-18, 9.3911485259046604e-18, 9.2326999017272392e-18,
+  9.073366778018311e-18, 8.9130919370758043e-18, 8.7518143417549127e-18,
+  8.5894687389797661e-18, 8.4259852098409034e-18, 8.2612886572117571e-18,
+  8.0952982199451778e-18, 7.9279266003788462e-18, 7.7590792889539916e-18,
+  7.5886536660589744e-18, 7.4165379565111788e-18, 7.2426100060659587e-18,
+  7.0667358415495839e-18, 6.8887679660438683e-18, 6.7085433271477403e-18,
+  6.5258808784908397e-18, 6.3405786306289335e-18, 6.1524100546599536e-18,
+  5.9611196565807947e-18, 5.7664174768539828e-18, 5.5679721791029641e-18,
+  5.3654022605531567e-18, 5.1582647227199333e-18, 4.9460402476219417e-18,
+  4.7281134710870614e-18, 4.5037462234180659e-18, 4.2720404252312837e-18,
+  4.0318853185454688e-18, 3.7818801629017279e-18, 3.5202169427471903e-18,
+  3.2444947153886174e-18, 2.9514100973039227e-18, 2.6362063868306081e-18,
+  2.29160610715468e-18, 1.9054893904415199e-18, 1.4549265620864029e-18,
+  8.8612678049442667e-19};
+const double rand55_zexp_f[257] = {
+  0.00016706669230796388, 0.00045413435384149676, 0.00096726928232717453,
+  0.0015362997803015724, 0.0021459677437189062, 0.002788798793574076,
+  0.003460264777836904, 0.0041572951208337953, 0.0048776559835423926,
+  0.0056196422072054832, 0.0063819059373191795, 0.0071633531836349842,
+  0.0079630774380170393, 0.0087803149858089753, 0.0096144136425022094,
+  0.01046481018102998, 0.011331013597834598, 0.012212592426255381,
+  0.013109164931254991, 0.014020391403181937, 0.014945968011691148,
+  0.015885621839973163, 0.016839106826039946, 0.017806200410911361,
+  0.01878670074469603, 0.019780424338009742, 0.020787204072578118,
+  0.021806887504283582, 0.022839335406385239, 0.02388442051155817,
+  0.024942026419731783, 0.026012046645134218, 0.027094383780955798,
+  0.028188948763978634, 0.029295660224637394, 0.030414443910466606,
+  0.031545232172893606, 0.032687963508959533, 0.033842582150874329,
+  0.035009037697397411, 0.03618728478193142, 0.03737728277295936,
+  0.03857899550307486, 0.039792391023374123, 0.041017441380414821,
+  0.042254122413316231, 0.043502413568888183, 0.044762297732943281,
+  0.046033761076175167, 0.047316792913181549, 0.048611385573379494,
+  0.049917534282706375, 0.05123523705512628, 0.05256449459307169,
+  0.053905310196046085, 0.055257689676697038, 0.056621641283742874,
+  0.057997175631200659, 0.059384305633420265, 0.060783046445479636,
+  0.062193415408540996, 0.063615431999807331, 0.065049117786753755,
+  0.066494496385339779, 0.067951593421936608, 0.069420436498728752,
+  0.070901055162371828, 0.072393480875708743, 0.073897746992364746,
+  0.075413888734058409, 0.07694194317048051, 0.078481949201606426,
+  0.08003394754231991, 0.081597980709237421, 0.08317409300963238,
+  0.084762330532368125, 0.086362741140756912, 0.087975374467270219,
+  0.089600281910032865, 0.091237516631040162, 0.092887133556043547,
+  0.094549189376055854, 0.0962237425504328, 0.0979108533114922,
+  0.099610583670637129, 0.10132299742595364, 0.10304816017125772,
+  0.10478613930657017, 0.10653700405000166, 0.1083008254510338,
+  0.11007767640518539, 0.1118676316700563, 0.11367076788274431,
+  0.11548716357863354, 0.11731689921155557, 0.11916005717532768,
+  0.12101672182667484, 0.12288697950954513, 0.12477091858083097,
+  0.12666862943751067, 0.12858020454522818, 0.13050573846833078,
+  0.13244532790138752, 0.13439907170221363, 0.13636707092642886,
+  0.13834942886358021, 0.14034625107486244, 0.1423576454324722,
+  0.14438372216063476, 0.14642459387834494, 0.14848037564386679,
+  0.1505511850010399, 0.15263714202744286, 0.15473836938446807,
+  0.15685499236936522, 0.15898713896931421, 0.16113493991759203,
+  0.16329852875190181, 0.16547804187493601, 0.16767361861725019,
+  0.16988540130252767, 0.17211353531532006, 0.17435816917135349,
+  0.1766194545904949, 0.17889754657247831, 0.18119260347549629,
+  0.18350478709776746, 0.18583426276219711, 0.1881811994042543,
+  0.1905457696631954, 0.19292814997677134, 0.19532852067956322,
+  0.19774706610509886, 0.20018397469191128, 0.20263943909370902,
+  0.20511365629383771, 0.20760682772422204, 0.21011915938898826,
+  0.21265086199297828, 0.21520215107537868, 0.21777324714870053,
+  0.2203643758433595, 0.22297576805812018, 0.22560766011668406,
+  0.22826029393071671, 0.23093391716962742, 0.23362878343743334,
+  0.23634515245705965, 0.23908329026244917, 0.24184346939887723,
+  0.24462596913189211, 0.24743107566532764, 0.25025908236886231,
+  0.25311029001562948, 0.25598500703041538, 0.25888354974901622,
+  0.26180624268936295, 0.2647534188350622, 0.26772541993204482,
+  0.27072259679906003, 0.27374530965280298, 0.27679392844851734,
+  0.2798688332369729, 0.28297041453878076, 0.28609907373707685,
+  0.28925522348967773, 0.29243928816189259, 0.29565170428126121,
+  0.29889292101558177, 0.30216340067569353, 0.30546361924459024,
+  0.30879406693456017, 0.31215524877417957, 0.31554768522712894,
+  0.31897191284495724, 0.32242848495608914, 0.3259179723935562,
+  0.32944096426413633, 0.33299806876180897, 0.33658991402867758,
+  0.34021714906678005, 0.34388044470450243, 0.34758049462163699,
+  0.35131801643748335, 0.35509375286678746, 0.35890847294874976,
+  0.36276297335481777, 0.36665807978151415, 0.37059464843514599,
+  0.37457356761590215, 0.37859575940958081, 0.38266218149600982,
+  0.38677382908413768, 0.39093173698479711, 0.39513698183329015,
+  0.39939068447523108, 0.40369401253053027, 0.40804818315203238,
+  0.41245446599716117, 0.41691418643300289, 0.4214287289976166,
+  0.42599954114303436, 0.43062813728845884, 0.4353161032156366,
+  0.44006510084235388, 0.44487687341454852, 0.44975325116275499,
+  0.45469615747461548, 0.45970761564213769, 0.46478975625042618,
+  0.46994482528396, 0.47517519303737738, 0.48048336393045423,
+  0.48587198734188494, 0.49134386959403256, 0.49690198724154955,
+  0.50254950184134769, 0.50828977641064284, 0.51412639381474856,
+  0.52006317736823357, 0.52610421398361973, 0.53225388026304327,
+  0.53851687200286187, 0.54489823767243964, 0.55140341654064132,
+  0.55803828226258748, 0.56480919291240022, 0.57172304866482579,
+  0.57878735860284503, 0.58601031847726803, 0.59340090169173342,
+  0.60096896636523225, 0.60872538207962207, 0.61668218091520762,
+  0.62485273870366593, 0.63325199421436608, 0.64189671642726607,
+  0.65080583341457105, 0.66000084107899974, 0.66950631673192478,
+  0.67935057226476539, 0.68956649611707799, 0.70019265508278817,
+  0.71127476080507598, 0.72286765959357201, 0.73503809243142352,
+  0.74786862198519511, 0.76146338884989625, 0.7759568520401156,
+  0.79152763697249566, 0.80842165152300838, 0.82699329664305034,
+  0.84778550062398962, 0.87170433238120364, 0.90046992992574644,
+  0.93814368086217468, 1};
+
+/* gauss: 128 layers, r = 3.4426198558966521, v = 0.0099125630353364611 */
+const double rand55_zgauss_r = 3.4426198558966521;
+const rand55_t rand55_zgauss_k[128] = {
+  66808818195613799UL, 67462502132120225UL, 68930870409633357UL, 69614581079040828UL,
+  70017030195228795UL, 70284534227624722UL, 70476226522049391UL, 70620815666930500UL,
+  70734006393379916UL, 70825148412608018UL, 70900172224296556UL, 70963029851110144UL,
+  71016461188280756UL, 71062428446024853UL, 71102375511975878UL, 71137389581302882UL,
+  71168305596526421UL, 71195775857058392UL, 71220317675956896UL, 71242346781851339UL,
+  71262201219558710UL, 71280158769682768UL, 71296449855394501UL, 71311267248286436UL,
+  71324773465664440UL, 71337106477507064UL, 71348384158596030UL, 71358707797299577UL,
+  71368164886909903UL, 71376831365479284UL, 71384773427503918UL, 71392049000149970UL,
+  71398708954389921UL, 71404798104974711UL, 71410356040931680UL, 71415417819084794UL,
+  71420014546122915UL, 71424173869411223UL, 71427920392631595UL, 71431276029145873UL,
+  71434260303478831UL, 71436890609350709UL, 71439182431129744UL, 71441149534331074UL,
+  71442804129790028UL, 71444157015331877UL, 71445217698105974UL, 71445994500218184UL,
+  71446494649857231UL, 71446724359748794UL, 71446688894470888UL, 71446392627913230UL,
+  71445839091952502UL, 71445031017236961UL, 71443970366821678UL, 71442658363264657UL,
+  71441095509680298UL, 71439281605146505UL, 71437215754772612UL, 71434896374654575UL,
+  71432321191869667UL, 71429487239593304UL, 71426390847354013UL, 71423027626377415UL,
+  71419392449905035UL, 71415479428307313UL, 71411281878740974UL, 71406792289027454UL,
+  71402002275349723UL, 71396902533277869UL, 71391482781537243UL, 71385731697824477UL,
+  71379636845853735UL, 71373184592674960UL, 71366360015144038UL, 71359146794237274UL,
+  71351527095684139UL, 71343481435136465UL, 71334988525791369UL, 71326025106029704UL,
+  71316565744209972UL, 71306582617255031UL, 71296045259067585UL, 71284920274087993UL,
+  71273171010436398UL, 71260757186025191UL, 71247634459742793UL, 71233753938238819UL,
+  71219061606911187UL, 71203497671314226UL, 71186995792252195UL, 71169482194137453UL,
+  71150874621570045UL, 71131081113263322UL, 71109998555035744UL, 71087510964126873UL,
+  71063487444920174UL, 71037779740373617UL, 71010219282844577UL, 70980613620845923UL,
+  70948742062200375UL, 70914350325691505UL, 70877143927800720UL, 70836779941447687UL,
+  70792856639495532UL, 70744900361756382UL, 70692348697052955UL, 70634528715734932UL,
+  70570628466813219UL, 70499659177985683UL, 70420404420210977UL, 70331350677358285UL,
+  70230590878456007UL, 70115687770184008UL, 69983476194781066UL, 69829769878908093UL,
+  69648914305960251UL, 69433082538281754UL, 69171123658593960UL, 68846593711851636UL,
+  68434202988746661UL, 67892968177329196UL, 67151864522140216UL, 66076294705843523UL,
+  64377012537448097UL, 61300587752429220UL, 54076415609057429UL, 0UL};
+const double rand55_zgauss_w[128] = {
+  5.1529423044376955e-17, 4.7775947863102521e-17, 4.4729289502534999e-17,
+  4.2788395857226903e-17, 4.1337714538139627e-17, 4.0167091972224548e-17,
+  3.9178734569738727e-17, 3.8318922651383506e-17, 3.755486995158822e-17,
+  3.68650445067591e-17, 3.6234518835784507e-17, 3.5652503531680689e-17,
+  3.5110937385083677e-17, 3.4603632766027497e-17, 3.4125732481631728e-17,
+  3.3673350851168454e-17, 3.3243328617752856e-17, 3.283306085502518e-17,
+  3.2440373184055165e-17, 3.2063430850590188e-17, 3.1700670695045907e-17,
+  3.1350749411314792e-17, 3.1012503614966893e-17, 3.0684918618166909e-17,
+  3.0367103721507258e-17, 3.0058272450850808e-17, 2.9757726593363806e-17,
+  2.9464843185747352e-17, 2.9179063820508595e-17, 2.8899885789853206e-17,
+  2.8626854699286877e-17, 2.8359558266336925e-17, 2.8097621082203343e-17,
+  2.7840700161360183e-17, 2.7588481140193032e-17, 2.7340675013555655e-17,
+  2.7097015319733754e-17, 2.6857255701227825e-17, 2.6621167782122257e-17,
+  2.6388539313419968e-17, 2.6159172546209437e-17, 2.5932882799361318e-17,
+  2.57094971939804e-17, 2.5488853531338341e-17, 2.527079929469385e-17,
+  2.5055190758433553e-17, 2.484189219046666e-17, 2.463077513588054e-17,
+  2.4421717771592076e-17, 2.4214604323174689e-17, 2.4009324536253867e-17,
+  2.3805773195885679e-17, 2.3603849688196023e-17, 2.3403457599289833e-17,
+  2.3204504347060953e-17, 2.3006900842062577e-17, 2.2810561174049541e-17,
+  2.2615402321189393e-17, 2.242134387926882e-17, 2.2228307808503892e-17,
+  2.203621819580338e-17, 2.1845001030539736e-17, 2.1654583992056785e-17,
+  2.1464896247290525e-17, 2.1275868257002951e-17, 2.1087431589230804e-17,
+  2.0899518738633913e-17, 2.0712062950492763e-17, 2.0524998048153357e-17,
+  2.03382582627503e-17, 2.0151778064056665e-17, 1.9965491991311997e-17,
+  1.9779334482867583e-17, 1.9593239703460389e-17, 1.9407141367883218e-17,
+  1.9220972559757363e-17, 1.9034665544033939e-17, 1.8848151571749001e-17,
+  1.8661360675433129e-17, 1.8474221453424984e-17, 1.8286660841156696e-17,
+  1.8098603867261775e-17, 1.7909973392097783e-17, 1.7720689825968801e-17,
+  1.7530670823967923e-17, 1.7339830953926518e-17, 1.7148081333441273e-17,
+  1.6955329231335172e-17, 1.6761477628173782e-17, 1.6566424729577314e-17,
+  1.6370063425009417e-17, 1.6172280683444214e-17, 1.5972956875761835e-17,
+  1.5771965011833138e-17, 1.5569169877941631e-17, 1.536442705734519e-17,
+  1.5157581813259793e-17, 1.4948467809166278e-17, 1.4736905635853995e-17,
+  1.4522701107696771e-17, 1.4305643281870778e-17, 1.4085502142981147e-17,
+  1.3862025881059607e-17, 1.3634937672018515e-17, 1.3403931844848263e-17,
+  1.316866928693805e-17, 1.2928771894756744e-17, 1.2683815817216029e-17,
+  1.2433323156677536e-17, 1.2176751677774263e-17, 1.1913481911791241e-17,
+  1.1642800810690682e-17, 1.1363880762550984e-17, 1.1075752268472833e-17,
+  1.0777267798691542e-17, 1.0467053119169041e-17, 1.0143440401814714e-17,
+  9.8043741363574859e-18, 9.4472751655791972e-18, 9.0688378850268035e-18,
+  8.6647161294402006e-18, 8.2290138931070675e-18, 7.753411501381063e-18,
+  7.2255540262847878e-18, 6.6257809968299202e-18, 5.9195424437678158e-18,
+  5.0358527213303681e-18, 3.7792111760118742e-18};
+const double rand55_zgauss_f[129] = {
+  0.0010143525641286154, 0.0026696290839025035, 0.0055489952208164705,
+  0.008624484412930471, 0.011839478657982314, 0.015167298010672042,
+  0.018592102737165813, 0.022103304616111593, 0.025693291936149617,
+  0.02935631744025383, 0.033087886146505156, 0.036884388786968774,
+  0.040742868074790605, 0.04466086220087243, 0.048636295860284052,
+  0.05266740190350317, 0.056752663481538584, 0.060890770348566376,
+  0.065080585213631874, 0.069321117394180253, 0.073611501884754893,
+  0.077950982514654714, 0.082338898242957408, 0.086774671895542969,
+  0.09125780082763471, 0.095787849122578152, 0.10036444102954554,
+  0.10498725541035454, 0.10965602101581776, 0.11437051244988827,
+  0.11913054670871859, 0.12393598020398174, 0.12878670619710396,
+  0.13368265258464764, 0.13862377998585104, 0.14361008009193299,
+  0.14864157424369697, 0.15371831220958657, 0.15884037114093508,
+  0.16400785468492775, 0.16922089223892475, 0.17447963833240232,
+  0.17978427212496211, 0.18513499701071343, 0.19053204032091372,
+  0.19597565311811041, 0.20146611007620324, 0.2070037094418738,
+  0.2125887730737361, 0.2182216465563706, 0.22390269938713389,
+  0.2296323252343027, 0.23541094226572766, 0.24123899354775132,
+  0.24711694751469674, 0.25304529850976586, 0.25902456739871074,
+  0.26505530225816194, 0.27113807914102527, 0.27727350292189771,
+  0.28346220822601252, 0.2897048604458105, 0.29600215684985584,
+  0.30235482778947976, 0.30876363800925192, 0.31522938806815752,
+  0.32175291587920862, 0.3283350983761524, 0.33497685331697116,
+  0.34167914123501368, 0.34844296754987247, 0.35526938485154714,
+  0.36215949537303321, 0.36911445366827514, 0.37613546951445443,
+  0.38322381105988365, 0.39038080824138949, 0.39760785649804255,
+  0.40490642081148835, 0.41227804010702462, 0.41972433205403823,
+  0.4272469983095624, 0.4348478302546619, 0.44252871528024661,
+  0.45029164368692696, 0.45813871627287196, 0.46607215269457098,
+  0.4740943006982496, 0.48220764633483869, 0.49041482528932164,
+  0.49871863547658432, 0.50712205108130459, 0.51562823824987205,
+  0.5242405726789928, 0.53296265938998759, 0.54179835503172412,
+  0.55075179312105528, 0.55982741271069482, 0.56902999107472161,
+  0.57836468112670231, 0.58783705444182053, 0.59745315095181228,
+  0.60721953663260489, 0.61714337082656249, 0.62723248525781457,
+  0.63749547734314487, 0.64794182111855081, 0.65858200005865368,
+  0.66942766735770617, 0.68049184100641433, 0.69178914344603585,
+  0.70333609902581742, 0.71515150742047704, 0.72725691835450588,
+  0.73967724368333815, 0.7524415591857038, 0.76558417390923599,
+  0.77914608594170317, 0.79317701178385921, 0.80773829469612111,
+  0.822907211395262, 0.83878360531064722, 0.85550060788506428,
+  0.87324304892685359, 0.89228165080230272, 0.91304364799203806,
+  0.93628268170837107, 0.9635996931557676, 1};